@@ -0,0 +1,205 @@
+/**
+ * @file LCDBenchmark.cpp
+ * @author Hisayuki Nomura
+ * @brief ST7032をコントローラーに使用した液晶用のライブラリの、出力方法ごとの速度を測るプログラム\n
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details 同じ文字列を、出力方法を変えて繰り返し出力し、最後の画面が液晶に送信されるまでの時間から求めた、
+ * １秒あたりに書き込めた文字数（chars/sec written）と、I2Cのトランザクション数、送信バイト数を、UARTの標準出力に表示します。
+ * lcd_printfは書き込んだ文字をすべて送信しますが、printf（標準出力のドライバ）は続けて出力された行をまとめ、
+ * 途中の画面は液晶に送信しません。そのため、printfの値は液晶に表示された文字数ではなく、同じ条件の比較にはなりません。
+ * スパークラインは、I2Cの速度ごとに１サンプルあたりの送信バイト数と、更新できる最大の速さ（samples/sec）を表示します。
+ * メニューは、選択の示し方と画面の切り替え方ごとに、選択を１つ動かすあたりの送信バイト数を表示します。\n
+ * 液晶の配線は、LCDDriver.cppと同じです。結果は、UART（GPIO0/GPIO1）に接続した端末で確認してください。
+ *
+ */
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "pico/stdio_uart.h"
+#include "hardware/i2c.h"
+#include "i2cLCD.h"
+#include "i2cLCDStdio.h"
+#include "i2cLCDSparkline.h"
+#include "i2cLCDMenu.h"
+
+/// @brief １つの測定で出力する回数
+#define BENCH_COUNT     500
+/// @brief スパークラインの測定で追加するサンプルの数
+#define BENCH_SAMPLES   200
+/// @brief メニューの測定で、一番下まで動かして一番上に戻る往復の回数
+#define BENCH_MENU_ROUNDS   5
+
+/// @brief メニューの測定に使う項目。配列ごとconstにして、フラッシュに置く
+static const char * const aryBenchMenuLabel[] = {
+    "Contrast", "Backlight", "Brightness", "Language", "Date/Time", "Alarm",
+    "Network", "Bluetooth", "Sensor Calib.", "Units", "Factory Reset", "About",
+};
+
+/**
+ * @brief 測定の結果を、UARTの標準出力に表示する。
+ *
+ * @param name 測定の名前
+ * @param chars 書き込んだ文字数
+ * @param note 結果の後ろに表示する説明
+ * @param startUs 測定を始めた時刻
+ * @param pStart 測定を始めたときのバスの統計
+ */
+static void bench_Report(const char *name, int chars, uint64_t startUs, LCDBusStats *pStart, const char *note)
+{
+    uint64_t us = time_us_64() - startUs;
+    LCDBusStats stats;
+    lcd_BusStatsGet(&stats);
+    printf("%-12s %8lu chars/sec written  %6lu transactions  %7lu bytes  %s\n", name,
+           (unsigned long)((uint64_t)chars * 1000000 / (us ? us : 1)),
+           (unsigned long)(stats.transactions - pStart->transactions),
+           (unsigned long)(stats.bytes - pStart->bytes), note);
+}
+
+/**
+ * @brief スパークラインにサンプルを追加して送信し、１サンプルあたりの送信量と、送信にかかった時間を表示する。
+ *
+ * @param hz I2Cのボーレート（Hz）
+ * @param isFill trueの場合は、線の下を塗りつぶす
+ * @details 三角波のサンプルを追加するたびにlcd_PixelFlush()で送信する。
+ * 表示の「samples/sec」は、バスが続けられる最大の更新の速さになる。
+ */
+static void bench_Sparkline(uint32_t hz, bool isFill)
+{
+    static LCDSparkline spark;
+    lcd_BusSpeedSet(hz);
+    lcd_ClearDisplay();
+    lcd_SparklineInit(&spark, 0, 12, 4, 2);
+    lcd_SparklineRangeSet(&spark, 0, 15);
+    lcd_SparklineFillSet(&spark, isFill);
+    lcd_Flush();
+    lcd_PixelFlush();
+    LCDBusStats start;
+    LCDBusStats stats;
+    lcd_BusStatsGet(&start);
+    uint64_t us = 0;
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        int phase = i % 30;
+        lcd_SparklinePush(&spark, (phase < 15) ? phase : 30 - phase);
+        uint64_t startUs = time_us_64();
+        lcd_PixelFlush();
+        us += time_us_64() - startUs;
+    }
+    lcd_BusStatsGet(&stats);
+    uint32_t bytes = stats.bytes - start.bytes;
+    printf("sparkline %s %3lukHz %5lu.%lu bytes/sample  %4lu us/sample  %5lu samples/sec\n", isFill ? "fill" : "line",
+           (unsigned long)(hz / 1000),
+           (unsigned long)(bytes / BENCH_SAMPLES), (unsigned long)(bytes * 10 / BENCH_SAMPLES % 10),
+           (unsigned long)(us / BENCH_SAMPLES),
+           (unsigned long)((uint64_t)BENCH_SAMPLES * 1000000 / (us ? us : 1)));
+}
+
+/**
+ * @brief メニューの選択を１つずつ動かして往復させ、選択を１つ動かすあたりの送信量を表示する。
+ *
+ * @param style 選択している項目の示し方
+ * @param isShift trueの場合は、表示のシフトでも画面を切り替える
+ * @details 同じ画面の中の移動（marker）と、画面をまたぐ移動（page）を分けて平均を表示する。
+ * 裏のページの先読みは、移動の合間にlcd_Flush()で送信し、移動のバイト数には含めない。
+ */
+static void bench_Menu(LCD_MENU_STYLE style, bool isShift)
+{
+    static LCDMenu menu;
+    int count = sizeof(aryBenchMenuLabel) / sizeof(aryBenchMenuLabel[0]);
+    lcd_ClearDisplay();
+    lcd_MenuInit(&menu, aryBenchMenuLabel, count, style, isShift);
+    lcd_Flush();
+    uint32_t markerBytes = 0;
+    uint32_t pageBytes = 0;
+    for (int round = 0; round < BENCH_MENU_ROUNDS; round++) {
+        for (int i = 0; i < (count - 1) * 2; i++) {
+            int top = menu.top;
+            int iRet = lcd_MenuMove(&menu, (i < count - 1) ? 1 : -1);
+            if (iRet > 0) {
+                if (menu.top == top) {
+                    markerBytes += iRet;
+                } else {
+                    pageBytes += iRet;
+                }
+            }
+            lcd_Flush();                        // 先読みを送信しておく
+        }
+    }
+    LCDMenuStats stats;
+    lcd_MenuStatsGet(&menu, &stats);
+    uint32_t pages = stats.diffPages + stats.shiftPages;
+    printf("menu %-6s %-5s %3lu.%lu bytes/step  marker %2lu.%lu  page %2lu.%lu  (diff %lu, shift %lu)\n",
+           (style == LCD_MENU_MARKER) ? "marker" : "cursor", isShift ? "shift" : "diff",
+           (unsigned long)(stats.bytes / stats.steps), (unsigned long)(stats.bytes * 10 / stats.steps % 10),
+           (unsigned long)(markerBytes / stats.markerSteps), (unsigned long)(markerBytes * 10 / stats.markerSteps % 10),
+           (unsigned long)(pageBytes / pages), (unsigned long)(pageBytes * 10 / pages % 10),
+           (unsigned long)stats.diffPages, (unsigned long)stats.shiftPages);
+    if (isShift) {
+        lcd_PageFlipMode(false);
+    }
+    lcd_CursorMode(true, false, false);
+}
+
+int main()
+{
+    stdio_init_all();
+
+    i2c_init(I2C_PORT, I2C_SPEED);
+    gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
+    gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
+    gpio_pull_up(I2C_SDA);
+    gpio_pull_up(I2C_SCL);
+
+    lcd_init();
+    lcd_CursorDisplay(false);
+    sleep_ms(2000);                         // 端末を接続する時間
+    printf("LCD benchmark: %d lines of %d chars, I2C %d Hz\n", BENCH_COUNT, MAX_CHARS, I2C_SPEED);
+
+    while (true) {
+        LCDBusStats start;
+        uint64_t startUs;
+
+        // lcd_printf：呼び出すたびに、カーソルの移動と文字列を直接送信する
+        lcd_ClearDisplay();
+        lcd_BusStatsGet(&start);
+        startUs = time_us_64();
+        for (int i = 0; i < BENCH_COUNT; i++) {
+            lcd_CursorPosition(1, 0);
+            lcd_printf("Count:%10d", i);
+        }
+        bench_Report("lcd_printf", BENCH_COUNT * MAX_CHARS, startUs, &start, "(every line sent)");
+
+        // printf：標準出力のドライバを通して、コンソールに出力し、まとめて送信する
+        lcd_ClearDisplay();
+        lcd_StdioInit(0, MAX_LINES);
+        stdio_set_driver_enabled(&stdio_uart, false);   // UARTの速度を含めないように、液晶だけに出力する
+        lcd_BusStatsGet(&start);
+        startUs = time_us_64();
+        for (int i = 0; i < BENCH_COUNT; i++) {
+            printf("Count:%9d\n", i);
+        }
+        fflush(stdout);
+        lcd_StdioEnable(false);                         // 送信を待っている最後の画面を送信してから、時間を測る
+        lcd_Flush();
+        stdio_set_driver_enabled(&stdio_uart, true);
+        bench_Report("printf", BENCH_COUNT * MAX_CHARS, startUs, &start, "(coalesced: only the final screens are sent)");
+
+        // スパークライン：100KHzと400KHzで、１サンプルあたりの送信量と更新できる速さ
+        bench_Sparkline(100 * 1000, false);
+        bench_Sparkline(400 * 1000, false);
+        bench_Sparkline(100 * 1000, true);
+        bench_Sparkline(400 * 1000, true);
+        lcd_BusSpeedSet(I2C_SPEED);
+
+        // メニュー：選択の示し方と、画面の切り替え方ごとの、選択を１つ動かすあたりの送信量
+        bench_Menu(LCD_MENU_MARKER, false);
+        bench_Menu(LCD_MENU_MARKER, true);
+        bench_Menu(LCD_MENU_CURSOR, false);
+        bench_Menu(LCD_MENU_CURSOR, true);
+
+        sleep_ms(5000);
+    }
+}
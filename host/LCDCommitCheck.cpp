@@ -0,0 +1,149 @@
+/**
+ * @file LCDCommitCheck.cpp
+ * @author Hisayuki Nomura
+ * @brief lcd_begin()/lcd_commit()のトランザクションが、１回のI2Cトランザクションで送信されることを、PC上で確認するプログラム。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details 液晶ライブラリ（i2cLCD.cpp、i2cLCDModel.cpp）を、pico SDKの代わりの関数（stub/）と一緒にコンパイルする。
+ * 値と単位を２行に書き換えるトランザクションをコミットし、送信が１回だけであることと、
+ * そのトランザクションを液晶と同じように解釈した結果が、書き換えた内容になることを確認する。
+ * 確認できた場合は０、できなかった場合は１を返す。
+ * @code
+ *  ./LCDCommitCheck
+ * @endcode
+ */
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "i2cLCD.h"
+#include "PicoStub.h"
+
+/**
+ * @brief トランザクションを解釈した結果。
+ */
+struct CommitCheckGlass {
+    /// @brief DDRAMの内容
+    uint8_t aryCell[2][DDRAM_CHARS];
+    /// @brief アイコンの値
+    uint8_t aryIcon[16];
+    /// @brief 最後のコントロールバイトのCoビットが落ちていた場合はtrue
+    bool isClosed;
+};
+
+/**
+ * @brief トランザクションを、ST7032と同じようにコントロールバイトのCoビットに従って解釈する。
+ *
+ * @param pGlass 解釈した結果を書き込む
+ * @param buf トランザクション
+ * @param length 長さ
+ * @details DDRAMとアイコンのアドレス設定、命令セットの切り替え、データの書き込みだけを解釈する。
+ */
+static void check_Decode(CommitCheckGlass *pGlass, const uint8_t *buf, int length)
+{
+    uint8_t addr = 0;
+    bool isIcon = false;
+    bool isExt = false;
+    int i = 0;
+    pGlass->isClosed = false;
+    while (i < length) {
+        uint8_t ctrl = buf[i++];
+        bool isCo = (ctrl & 0x80) != 0;
+        int end = isCo ? i + 1 : length;
+        if (!isCo) pGlass->isClosed = true;
+        for (; i < end && i < length; i++) {
+            uint8_t val = buf[i];
+            if (ctrl & 0x40) {
+                if (isIcon) {
+                    pGlass->aryIcon[addr & 0x0F] = val;
+                } else {
+                    pGlass->aryCell[(addr & 0x40) ? 1 : 0][addr & 0x3F] = val;
+                    addr++;
+                }
+            } else if (val & 0x80) {
+                addr = val & 0x7F;
+                isIcon = false;
+            } else if ((val & 0xE0) == 0x20) {
+                isExt = (val & 0x01) != 0;
+            } else if (isExt && (val & 0xF0) == 0x40) {
+                addr = val & 0x0F;
+                isIcon = true;
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int errors = 0;
+    lcd_init();
+
+    // トランザクションを使わずに、値と単位を書き換える場合
+    uint32_t writes = stub_I2CWriteCount();
+    lcd_CursorPosition(0, 0);
+    lcd_string("T= 23.4");
+    lcd_CursorPosition(0, 8);
+    lcd_string("degC");
+    lcd_CursorPosition(1, 0);
+    lcd_string("OK");
+    printf("direct: %u transactions\n", stub_I2CWriteCount() - writes);
+
+    // 同じ書き換えを、トランザクションの中で行う場合
+    writes = stub_I2CWriteCount();
+    lcd_begin();
+    lcd_CursorPosition(0, 0);
+    lcd_string("T= 24.5");
+    lcd_CursorPosition(0, 8);
+    lcd_string("degF");
+    lcd_CursorPosition(1, 0);
+    lcd_string("NG");
+    lcd_ModelIconSet(true, (LCD_ICON)0x0110);
+    uint32_t inside = stub_I2CWriteCount() - writes;
+    int bytes = lcd_commit();
+    uint32_t commitWrites = stub_I2CWriteCount() - writes;
+    printf("commit: %u transactions, %d bytes\n", commitWrites, bytes);
+    if (inside != 0) {
+        printf("NG: %u transactions before lcd_commit()\n", inside);
+        errors++;
+    }
+    if (commitWrites != 1) {
+        printf("NG: lcd_commit() sent %u transactions\n", commitWrites);
+        errors++;
+    }
+
+    CommitCheckGlass glass;
+    memset(&glass, ' ', sizeof(glass.aryCell));
+    memset(glass.aryIcon, 0, sizeof(glass.aryIcon));
+    const uint8_t *pData;
+    int length = stub_I2CLastWrite(&pData);
+    check_Decode(&glass, pData, length);
+    if (!glass.isClosed) {
+        printf("NG: the last control byte has the Co bit\n");
+        errors++;
+    }
+    if (memcmp(&glass.aryCell[0][4], "4.5", 3) != 0 || glass.aryCell[0][11] != 'F' || memcmp(glass.aryCell[1], "NG", 2) != 0) {
+        printf("NG: the transaction does not write the committed text\n");
+        errors++;
+    }
+    if (glass.aryIcon[1] != 0x10) {
+        printf("NG: the transaction does not set the icon\n");
+        errors++;
+    }
+    printf("  |%.16s|  (cells written by the commit)\n  |%.16s|\n", (const char *)glass.aryCell[0], (const char *)glass.aryCell[1]);
+
+    // 変更が無い場合は、何も送信しない
+    writes = stub_I2CWriteCount();
+    lcd_begin();
+    lcd_CursorPosition(0, 8);
+    lcd_string("degF");
+    lcd_commit();
+    if (stub_I2CWriteCount() != writes) {
+        printf("NG: an unchanged commit sent %u transactions\n", stub_I2CWriteCount() - writes);
+        errors++;
+    }
+    printf(errors == 0 ? "OK\n" : "NG: %d errors\n", errors);
+    return errors == 0 ? 0 : 1;
+}
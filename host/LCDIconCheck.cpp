@@ -0,0 +1,104 @@
+/**
+ * @file LCDIconCheck.cpp
+ * @author Hisayuki Nomura
+ * @brief lcd_IconSet()で直接送信したアイコンと、表示内容のモデルのアイコンが、同じアドレスで混ざっても失われないことを、PC上で確認するプログラム。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details 液晶ライブラリ（i2cLCD.cpp、i2cLCDModel.cpp）を、pico SDKの代わりの関数（stub/）と一緒にコンパイルする。
+ * UPとDOWNは同じアドレス（７）にある。lcd_ModelIconSet()でまだ送信していないビットがある間に、
+ * lcd_IconSet()で同じアドレスの別のビットを送信し、lcd_Flush()の後に両方が表示されることを確認する。
+ * また、点滅させているアイコンが消えている側の半周期に、同じアドレスの別のアイコンをlcd_IconSet()で表示しても、
+ * 点滅しているアイコンがモデルから消えず、次の半周期で再び表示されることを確認する。\n
+ * 確認できた場合は０、できなかった場合は１を返す。
+ * @code
+ *  ./LCDIconCheck
+ * @endcode
+ */
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "i2cLCD.h"
+#include "i2cLCDlocal.h"
+#include "PicoStub.h"
+
+/**
+ * @brief モデルと液晶のアイコンの値を調べる。
+ *
+ * @param title 表示する見出し
+ * @param iconAddr アイコンのアドレス
+ * @param model モデルに期待する値
+ * @param sent 液晶に期待する値
+ * @return int 一致しなかった場合は１、一致した場合は０
+ */
+static int check_Icon(const char *title, int iconAddr, uint8_t model, uint8_t sent)
+{
+    uint8_t modelValue = lcdModel.aryIconCell[iconAddr];
+    uint8_t sentValue = lcdSetting.aryIconValue[iconAddr];
+    printf("%s: model 0x%02X, sent 0x%02X\n", title, modelValue, sentValue);
+    if (modelValue == model && sentValue == sent) return 0;
+    printf("NG: expected model 0x%02X, sent 0x%02X\n", model, sent);
+    return 1;
+}
+
+/**
+ * @brief 点滅しているアイコンと同じアドレスの別のアイコンを、消えている側の半周期にlcd_IconSet()で表示する。
+ *
+ * @param blink 点滅させるアイコン
+ * @param direct 直接表示するアイコン（blinkと同じアドレス）
+ * @return int 一致しなかった数
+ */
+static int check_BlinkDirect(LCD_ICON blink, LCD_ICON direct)
+{
+    int errors = 0;
+    int iconAddr = (blink >> 8) & 0x0F;
+    uint8_t blinkBits = blink & 0x1F;
+    uint8_t directBits = direct & 0x1F;
+    uint32_t halfUs = LCD_BLINK_PERIOD_MS * 1000 / 2;
+    lcd_IconSetAll(false);
+    lcd_ModelIconSet(true, blink);
+    lcd_BlinkIconSet(blink, true);
+    // 表示している側の半周期の先頭まで進める
+    stub_TimeAdvance(2 * halfUs - time_us_64() % (2 * halfUs));
+    lcd_flush_step(100000);
+    errors += check_Icon("blink on", iconAddr, blinkBits, blinkBits);
+    stub_TimeAdvance(halfUs);
+    lcd_flush_step(100000);
+    errors += check_Icon("blink off", iconAddr, blinkBits, 0);
+    lcd_IconSet(true, direct);
+    errors += check_Icon("direct during off", iconAddr, blinkBits | directBits, directBits);
+    stub_TimeAdvance(halfUs);
+    lcd_flush_step(100000);
+    errors += check_Icon("blink on again", iconAddr, blinkBits | directBits, blinkBits | directBits);
+    lcd_BlinkIconSet(blink, false);
+    return errors;
+}
+
+int main(int argc, char *argv[])
+{
+    int errors = 0;
+    lcd_init();
+
+    // モデルでUPを表示（未送信）してから、直接DOWNを表示する
+    lcd_ModelIconSet(true, LCD_ICON::UP);
+    lcd_IconSet(true, LCD_ICON::DOWN);
+    errors += check_Icon("direct DOWN", 7, 0x18, 0x08);
+    lcd_Flush();
+    errors += check_Icon("flush", 7, 0x18, 0x18);
+
+    // 直接消去したビットは、モデルからも消える
+    lcd_IconSet(false, LCD_ICON::UP);
+    errors += check_Icon("direct UP off", 7, 0x08, 0x08);
+    lcd_IconSetAll(false);
+    errors += check_Icon("all off", 7, 0x00, 0x00);
+
+    // 点滅と直接の表示が同じアドレスで混ざる場合（13：BAT1～3とBATTERY、7：UPとDOWN）
+    errors += check_BlinkDirect(LCD_ICON::BATTERY, LCD_ICON::BAT1);
+    errors += check_BlinkDirect(LCD_ICON::UP, LCD_ICON::DOWN);
+
+    printf(errors == 0 ? "OK\n" : "NG: %d errors\n", errors);
+    return errors == 0 ? 0 : 1;
+}
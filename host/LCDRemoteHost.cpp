@@ -0,0 +1,269 @@
+/**
+ * @file LCDRemoteHost.cpp
+ * @author Hisayuki Nomura
+ * @brief PCから、差分の通信プロトコル（i2cLCDRemoteProto.h）で液晶の表示を送るライブラリ。\n
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details lcd_RemoteHostWrite()などで表示したい内容を書き込み、lcd_RemoteHostFlush()で、液晶に送った内容と異なる部分だけを送信する。
+ * 液晶からLCD_REMOTE_NAKが返ってきた場合は、lcd_RemoteHostPoll()が画面全体を送り直す。
+ *
+ * @code
+ *  LCDRemoteHost host;
+ *  lcd_RemoteHostInit(&host, fd);
+ *  lcd_RemoteHostWrite(&host, 0, 0, "TEMP: 23.5C", -1);
+ *  lcd_RemoteHostFlush(&host);
+ *  while (true) {
+ *      lcd_RemoteHostPoll(&host);
+ *      ...
+ *  }
+ * @endcode
+ */
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <poll.h>
+#include "LCDRemoteHost.h"
+
+/**
+ * @brief フレームを組み立てて送信する。
+ *
+ * @param pHost 送信の状態
+ * @param type 種類
+ * @param pPayload payload
+ * @param length payloadの長さ
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ * @details ファイルディスクリプタがO_NONBLOCKで送信バッファが一杯の場合は、LCD_REMOTE_SEND_TIMEOUT_MSまで待って送り直す。
+ * フレームの途中で送信をやめると、液晶側で番号が揃わなくなるので、待っても送れなかった場合だけエラーにする。
+ */
+static int lcd_RemoteHostSend(LCDRemoteHost *pHost, uint8_t type, const uint8_t *pPayload, int length)
+{
+    uint8_t aryFrame[LCD_REMOTE_FRAME_MAX];
+    int frameLength = lcd_RemoteEncode(aryFrame, pHost->seq, type, pPayload, length);
+    if (frameLength < 0) return -1;
+    int written = 0;
+    while (written < frameLength) {
+        ssize_t n = write(pHost->fd, &aryFrame[written], frameLength - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return -1;
+            // O_NONBLOCKで送信バッファが一杯の場合は、書き込めるようになるまで待つ
+            struct pollfd pfd = { pHost->fd, POLLOUT, 0 };
+            int iPoll = poll(&pfd, 1, LCD_REMOTE_SEND_TIMEOUT_MS);
+            if (iPoll < 0 && errno == EINTR) continue;
+            if (iPoll <= 0) return -1;
+            continue;
+        }
+        written += (int)n;
+    }
+    pHost->seq++;
+    pHost->bytes += frameLength;
+    pHost->frames++;
+    return frameLength;
+}
+/**
+ * @brief 送信の状態を初期化し、画面全体（空白）を送る。
+ *
+ * @param pHost 初期化する状態
+ * @param fd 送信先のファイルディスクリプタ。シリアルポートの場合は、あらかじめrawモードにしておく。
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ */
+int lcd_RemoteHostInit(LCDRemoteHost *pHost, int fd)
+{
+    memset(pHost, 0, sizeof(LCDRemoteHost));
+    pHost->fd = fd;
+    memset(pHost->aryCell, ' ', sizeof(pHost->aryCell));
+    lcd_RemoteParserInit(&pHost->parser);
+    return lcd_RemoteHostResync(pHost);
+}
+/**
+ * @brief 表示したい内容に、文字列を書き込む。送信はlcd_RemoteHostFlush()で行う。
+ *
+ * @param pHost 送信の状態
+ * @param line 行
+ * @param column DDRAMのカラム
+ * @param s 書き込む文字列
+ * @param length 長さ。負の値の場合はNULL文字まで。
+ * @return int 書き込んだ文字数。行の最後を超えた部分は捨てる。範囲外の場合は-1。
+ */
+int lcd_RemoteHostWrite(LCDRemoteHost *pHost, int line, int column, const char *s, int length)
+{
+    if (line < 0 || line >= LCD_REMOTE_LINES || column < 0 || column >= LCD_REMOTE_COLUMNS) return -1;
+    if (length < 0) {
+        length = (int)strlen(s);
+    }
+    if (length > LCD_REMOTE_COLUMNS - column) {
+        length = LCD_REMOTE_COLUMNS - column;
+    }
+    memcpy(&pHost->aryCell[line][column], s, length);
+    return length;
+}
+/**
+ * @brief アイコンの値を設定する。送信はlcd_RemoteHostFlush()で行う。
+ *
+ * @param pHost 送信の状態
+ * @param iconAddr アイコンのアドレス（０～１５）
+ * @param value 値（下位５ビット）
+ * @return int ０。範囲外の場合は-1。
+ */
+int lcd_RemoteHostIconSet(LCDRemoteHost *pHost, int iconAddr, uint8_t value)
+{
+    if (iconAddr < 0 || iconAddr >= 16) return -1;
+    pHost->aryIcon[iconAddr] = value & 0x1F;
+    return 0;
+}
+/**
+ * @brief 外字のパターンを設定する。送信はlcd_RemoteHostFlush()で行う。
+ *
+ * @param pHost 送信の状態
+ * @param code 文字コード（０～７）
+ * @param pPattern パターン（8バイト）
+ * @return int ０。範囲外の場合は-1。
+ */
+int lcd_RemoteHostGlyphSet(LCDRemoteHost *pHost, int code, const uint8_t *pPattern)
+{
+    if (code < 0 || code >= 8) return -1;
+    if ((pHost->glyphUsed & (1 << code)) && memcmp(pHost->aryGlyph[code], pPattern, 8) == 0) return 0;
+    memcpy(pHost->aryGlyph[code], pPattern, 8);
+    pHost->glyphUsed |= (1 << code);
+    pHost->glyphDirty |= (1 << code);
+    return 0;
+}
+/**
+ * @brief カーソルの位置と形を設定する。送信はlcd_RemoteHostFlush()で行う。
+ *
+ * @param pHost 送信の状態
+ * @param line 行
+ * @param column DDRAMのカラム
+ * @param flags LCD_REMOTE_CURSOR_VISIBLE、LCD_REMOTE_CURSOR_UNDERLINE、LCD_REMOTE_CURSOR_BLINKの組み合わせ
+ * @return int ０。範囲外の場合は-1。
+ */
+int lcd_RemoteHostCursorSet(LCDRemoteHost *pHost, int line, int column, uint8_t flags)
+{
+    if (line < 0 || line >= LCD_REMOTE_LINES || column < 0 || column >= LCD_REMOTE_COLUMNS) return -1;
+    pHost->aryCursor[0] = line;
+    pHost->aryCursor[1] = column;
+    pHost->aryCursor[2] = flags;
+    return 0;
+}
+/**
+ * @brief 表示したい内容のうち、液晶に送った内容と異なる部分だけを送信する。
+ *
+ * @param pHost 送信の状態
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ * @details 行ごとに、異なるセルのランを探して１つのフレームで送る。LCD_REMOTE_MERGE_GAP以下の隙間をはさんだランは、
+ * 別のフレームにするより短いので、１つのランにまとめる。
+ */
+int lcd_RemoteHostFlush(LCDRemoteHost *pHost)
+{
+    int iSendBytes = 0;
+    int iRet;
+    uint8_t aryPayload[LCD_REMOTE_PAYLOAD_MAX];
+    for (int code = 0; code < 8; code++) {
+        if (!(pHost->glyphDirty & (1 << code))) continue;
+        aryPayload[0] = code;
+        memcpy(&aryPayload[1], pHost->aryGlyph[code], 8);
+        iRet = lcd_RemoteHostSend(pHost, LCD_REMOTE_GLYPH, aryPayload, 9);
+        if (iRet < 0) return iRet;
+        iSendBytes += iRet;
+        pHost->glyphDirty &= ~(1 << code);
+    }
+    for (int line = 0; line < LCD_REMOTE_LINES; line++) {
+        int col = 0;
+        while (col < LCD_REMOTE_COLUMNS) {
+            if (pHost->aryCell[line][col] == pHost->arySent[line][col]) {
+                col++;
+                continue;
+            }
+            int from = col;
+            int to = col + 1;           // 最後の異なるセル+1
+            for (int c = to; c < LCD_REMOTE_COLUMNS && c - to <= LCD_REMOTE_MERGE_GAP; c++) {
+                if (pHost->aryCell[line][c] != pHost->arySent[line][c]) to = c + 1;
+            }
+            aryPayload[0] = line;
+            aryPayload[1] = from;
+            memcpy(&aryPayload[2], &pHost->aryCell[line][from], to - from);
+            iRet = lcd_RemoteHostSend(pHost, LCD_REMOTE_CELLS, aryPayload, to - from + 2);
+            if (iRet < 0) return iRet;
+            iSendBytes += iRet;
+            memcpy(&pHost->arySent[line][from], &pHost->aryCell[line][from], to - from);
+            col = to;
+        }
+    }
+    int length = 0;
+    for (int addr = 0; addr < 16; addr++) {
+        if (pHost->aryIcon[addr] == pHost->aryIconSent[addr]) continue;
+        aryPayload[length++] = addr;
+        aryPayload[length++] = pHost->aryIcon[addr];
+    }
+    if (length > 0) {
+        iRet = lcd_RemoteHostSend(pHost, LCD_REMOTE_ICONS, aryPayload, length);
+        if (iRet < 0) return iRet;
+        iSendBytes += iRet;
+        memcpy(pHost->aryIconSent, pHost->aryIcon, sizeof(pHost->aryIcon));
+    }
+    if (memcmp(pHost->aryCursor, pHost->aryCursorSent, 3) != 0) {
+        iRet = lcd_RemoteHostSend(pHost, LCD_REMOTE_CURSOR, pHost->aryCursor, 3);
+        if (iRet < 0) return iRet;
+        iSendBytes += iRet;
+        memcpy(pHost->aryCursorSent, pHost->aryCursor, 3);
+    }
+    return iSendBytes;
+}
+/**
+ * @brief LCD_REMOTE_RESETに続けて、画面全体、アイコン、外字、カーソルを送り直す。
+ *
+ * @param pHost 送信の状態
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ */
+int lcd_RemoteHostResync(LCDRemoteHost *pHost)
+{
+    int iRet = lcd_RemoteHostSend(pHost, LCD_REMOTE_RESET, NULL, 0);
+    if (iRet < 0) return iRet;
+    // 液晶に送った内容を、すべて異なる値にしておけば、lcd_RemoteHostFlush()がすべてを送る
+    for (int line = 0; line < LCD_REMOTE_LINES; line++) {
+        for (int col = 0; col < LCD_REMOTE_COLUMNS; col++) {
+            pHost->arySent[line][col] = ~pHost->aryCell[line][col];
+        }
+    }
+    for (int addr = 0; addr < 16; addr++) {
+        pHost->aryIconSent[addr] = ~pHost->aryIcon[addr];
+    }
+    pHost->glyphDirty = pHost->glyphUsed;
+    pHost->aryCursorSent[2] = ~pHost->aryCursor[2];
+    pHost->resyncs++;
+    int iFlush = lcd_RemoteHostFlush(pHost);
+    if (iFlush < 0) return iFlush;
+    return iRet + iFlush;
+}
+/**
+ * @brief 液晶からのフレームを読み、再送の要求があれば画面全体を送り直す。
+ *
+ * @param pHost 送信の状態
+ * @return int 送り直した場合は送信したバイト数、要求が無い場合は０。負の値の場合はエラー。
+ * @details ファイルディスクリプタは、O_NONBLOCKにしておくこと。読めるデータが無い場合は、すぐに戻る。
+ */
+int lcd_RemoteHostPoll(LCDRemoteHost *pHost)
+{
+    uint8_t aryBuf[64];
+    bool isNak = false;
+    while (true) {
+        ssize_t n = read(pHost->fd, aryBuf, sizeof(aryBuf));
+        if (n <= 0) {
+            if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) return -1;
+            break;
+        }
+        for (ssize_t i = 0; i < n; i++) {
+            if (lcd_RemoteParse(&pHost->parser, aryBuf[i]) && pHost->parser.aryFrame[1] == LCD_REMOTE_NAK) {
+                isNak = true;
+            }
+        }
+    }
+    if (!isNak) return 0;
+    return lcd_RemoteHostResync(pHost);
+}
@@ -0,0 +1,68 @@
+/**
+ * @file LCDRemoteHost.h
+ * @author Hisayuki Nomura
+ * @brief PCから、差分の通信プロトコル（i2cLCDRemoteProto.h）で液晶の表示を送るライブラリのヘッダファイル。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details Linuxなどで、シリアルポート（USB CDCやUART）、pty、ソケットのファイルディスクリプタに送信する。
+ */
+#ifndef __LCDRemoteHost_h__
+#define __LCDRemoteHost_h__
+
+#include "i2cLCDRemoteProto.h"
+
+/// @brief 差分のランを１つのフレームにまとめる、変わっていないセルの最大の数。フレームの余分なバイト（6バイト）より短い隙間はまとめて送る。
+#define LCD_REMOTE_MERGE_GAP    6
+/// @brief 送信バッファが空くのを待つ最大の時間（ミリ秒）
+#define LCD_REMOTE_SEND_TIMEOUT_MS  1000
+
+/**
+ * @brief PC側の送信の状態。液晶に表示したい内容と、液晶に送った内容を持つ。
+ */
+struct LCDRemoteHost {
+    /// @brief 送信先のファイルディスクリプタ
+    int fd;
+    /// @brief 次に送るフレームの番号
+    uint8_t seq;
+    /// @brief 表示したい内容
+    uint8_t aryCell[LCD_REMOTE_LINES][LCD_REMOTE_COLUMNS];
+    /// @brief 液晶に送った内容
+    uint8_t arySent[LCD_REMOTE_LINES][LCD_REMOTE_COLUMNS];
+    /// @brief 表示したいアイコンの値
+    uint8_t aryIcon[16];
+    /// @brief 液晶に送ったアイコンの値
+    uint8_t aryIconSent[16];
+    /// @brief 外字のパターン
+    uint8_t aryGlyph[8][8];
+    /// @brief 外字を使用している場合は、その文字コードのビットが立つ
+    uint8_t glyphUsed;
+    /// @brief 送っていない外字の文字コードのビット
+    uint8_t glyphDirty;
+    /// @brief カーソルの行、カラム、フラグ（LCD_REMOTE_CURSOR_xxx）
+    uint8_t aryCursor[3];
+    /// @brief 液晶に送ったカーソルの状態
+    uint8_t aryCursorSent[3];
+    /// @brief 液晶から受信したフレームを取り出す状態
+    LCDRemoteParser parser;
+    /// @brief 送信したバイト数
+    uint32_t bytes;
+    /// @brief 送信したフレームの数
+    uint32_t frames;
+    /// @brief 画面全体を送り直した回数
+    uint32_t resyncs;
+};
+
+int lcd_RemoteHostInit(LCDRemoteHost *pHost, int fd);
+int lcd_RemoteHostWrite(LCDRemoteHost *pHost, int line, int column, const char *s, int length);
+int lcd_RemoteHostIconSet(LCDRemoteHost *pHost, int iconAddr, uint8_t value);
+int lcd_RemoteHostGlyphSet(LCDRemoteHost *pHost, int code, const uint8_t *pPattern);
+int lcd_RemoteHostCursorSet(LCDRemoteHost *pHost, int line, int column, uint8_t flags);
+int lcd_RemoteHostFlush(LCDRemoteHost *pHost);
+int lcd_RemoteHostResync(LCDRemoteHost *pHost);
+int lcd_RemoteHostPoll(LCDRemoteHost *pHost);
+
+#endif
@@ -0,0 +1,198 @@
+/**
+ * @file LCDRemoteLoopback.cpp
+ * @author Hisayuki Nomura
+ * @brief LCDRemoteHostの動作を、Linuxのsocketpairまたはシリアルポートで確認するプログラム。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details 引数が無い場合は、socketpairの反対側で液晶側のi2cLCDRemote.cpp（lcd_RemoteFeed()）を動かし、
+ * 表示内容のモデルの代わり（stub/LCDModelStub.cpp）に書き込まれた内容を端末に表示する。
+ * 通信路のノイズで壊れたフレームから回復することと、途中でフレームを１つ落とし、画面全体を送り直して回復することを確認する。
+ * PCが表示したい内容と液晶側のモデルの内容が一致した場合は０、一致しなかった場合は１を返す。\n
+ * 引数にデバイス（/dev/ttyACM0や、socatで作ったpty）を指定した場合は、rawモードで開いて同じ表示を送る。
+ * @code
+ *  ./LCDRemoteLoopback
+ *  ./LCDRemoteLoopback /dev/ttyACM0
+ * @endcode
+ */
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/socket.h>
+#include "pico/stdlib.h"
+#include "LCDRemoteHost.h"
+#include "i2cLCDRemote.h"
+#include "LCDModelStub.h"
+
+/// @brief 液晶側のファイルディスクリプタ
+static int loopbackDeviceFd = -1;
+
+/**
+ * @brief 液晶側からPCにフレームを送る（lcd_RemoteInit()に渡す関数）。
+ *
+ * @param buf フレーム
+ * @param length 長さ
+ */
+static void loopback_DeviceSend(const uint8_t *buf, int length)
+{
+    printf("  device: NAK\n");
+    if (write(loopbackDeviceFd, buf, length) != length) perror("write");
+}
+/**
+ * @brief 受信できたバイトを、液晶側のlcd_RemoteFeed()に渡す。
+ *
+ * @return int 表示に反映したフレームの数
+ */
+static int loopback_DevicePoll(void)
+{
+    uint8_t aryBuf[256];
+    ssize_t n;
+    int frames = 0;
+    while ((n = read(loopbackDeviceFd, aryBuf, sizeof(aryBuf))) > 0) {
+        frames += lcd_RemoteFeed(aryBuf, (int)n);
+    }
+    return frames;
+}
+/**
+ * @brief 液晶側のモデルの、表示可能な16カラムを表示する。
+ */
+static void loopback_DevicePrint(void)
+{
+    for (int line = 0; line < LCD_REMOTE_LINES; line++) {
+        char aryLine[17];
+        for (int column = 0; column < 16; column++) {
+            aryLine[column] = (char)stub_ModelCell(line, column);
+        }
+        aryLine[16] = '\0';
+        printf("  |%s|\n", aryLine);
+    }
+}
+/**
+ * @brief PCが表示したい内容と、液晶側のモデルの内容を比べる。
+ *
+ * @param pHost 送信の状態
+ * @return int 一致しなかったセル、アイコン、外字、カーソルの数
+ */
+static int loopback_DeviceCheck(const LCDRemoteHost *pHost)
+{
+    int errors = 0;
+    for (int line = 0; line < LCD_REMOTE_LINES; line++) {
+        for (int column = 0; column < LCD_REMOTE_COLUMNS; column++) {
+            if (stub_ModelCell(line, column) != pHost->aryCell[line][column]) errors++;
+        }
+    }
+    for (int addr = 0; addr < 16; addr++) {
+        if (stub_ModelIcon(addr) != pHost->aryIcon[addr]) errors++;
+    }
+    for (int code = 0; code < 8; code++) {
+        if ((pHost->glyphUsed & (1 << code)) && memcmp(stub_ModelGlyph(code), pHost->aryGlyph[code], 8) != 0) errors++;
+    }
+    int line, column;
+    bool isShown = stub_ModelCursor(&line, &column);
+    if (line != pHost->aryCursor[0] || column != pHost->aryCursor[1]
+        || isShown != ((pHost->aryCursor[2] & LCD_REMOTE_CURSOR_VISIBLE) != 0)) errors++;
+    if (errors != 0) printf("NG: %d cells differ from the host\n", errors);
+    return errors;
+}
+/**
+ * @brief シリアルポートをrawモードで開く。
+ *
+ * @param path デバイスのパス
+ * @return int ファイルディスクリプタ。負の値の場合はエラー。
+ */
+static int loopback_SerialOpen(const char *path)
+{
+    int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0) return -1;
+    struct termios tio;
+    if (tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        cfsetspeed(&tio, B115200);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    return fd;
+}
+
+int main(int argc, char *argv[])
+{
+    LCDRemoteHost host;
+    int aryFd[2];
+    int errors = 0;
+    bool isLoopback = (argc < 2);
+    if (isLoopback) {
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, aryFd) < 0) {
+            perror("socketpair");
+            return 1;
+        }
+        fcntl(aryFd[0], F_SETFL, O_NONBLOCK);
+        fcntl(aryFd[1], F_SETFL, O_NONBLOCK);
+        loopbackDeviceFd = aryFd[1];
+        stub_ModelReset();
+        lcd_RemoteInit(loopback_DeviceSend);
+    } else {
+        aryFd[0] = loopback_SerialOpen(argv[1]);
+        if (aryFd[0] < 0) {
+            perror(argv[1]);
+            return 1;
+        }
+    }
+
+    int bytes = lcd_RemoteHostInit(&host, aryFd[0]);
+    printf("init: %d bytes\n", bytes);
+    lcd_RemoteHostWrite(&host, 0, 0, "TEMP: 23.5C", -1);
+    lcd_RemoteHostWrite(&host, 1, 0, "HUMI: 45%", -1);
+    printf("first screen: %d bytes\n", lcd_RemoteHostFlush(&host));
+    lcd_RemoteHostWrite(&host, 0, 9, "6", 1);
+    printf("one digit: %d bytes\n", lcd_RemoteHostFlush(&host));
+    if (isLoopback) {
+        loopback_DevicePoll();
+        loopback_DevicePrint();
+        errors += loopback_DeviceCheck(&host);
+
+        // 通信路のノイズで、SOFと壊れた長さがフレームの前に入った場合。壊れたフレームの中のSOFから探し直して回復する
+        const uint8_t aryNoise[] = { LCD_REMOTE_SOF, 0x03, 0x01, 0x02 };
+        if (write(aryFd[0], aryNoise, sizeof(aryNoise)) != (ssize_t)sizeof(aryNoise)) perror("write");
+        lcd_RemoteHostIconSet(&host, 1, 0x10);
+        const uint8_t aryDegree[8] = { 0x0C, 0x12, 0x12, 0x0C, 0x00, 0x00, 0x00, 0x00 };
+        lcd_RemoteHostGlyphSet(&host, 2, aryDegree);
+        lcd_RemoteHostCursorSet(&host, 1, 15, LCD_REMOTE_CURSOR_VISIBLE | LCD_REMOTE_CURSOR_UNDERLINE);
+        printf("after noise: %d bytes\n", lcd_RemoteHostFlush(&host));
+        loopback_DevicePoll();
+        errors += loopback_DeviceCheck(&host);
+
+        // 通信路でフレームが１つ失われた場合
+        host.seq++;
+        lcd_RemoteHostWrite(&host, 1, 6, "50", 2);
+        printf("after drop: %d bytes\n", lcd_RemoteHostFlush(&host));
+        loopback_DevicePoll();
+        printf("resync: %d bytes\n", lcd_RemoteHostPoll(&host));
+        loopback_DevicePoll();
+        loopback_DevicePrint();
+        errors += loopback_DeviceCheck(&host);
+
+        LCDRemoteStats stats;
+        lcd_RemoteStatsGet(&stats);
+        printf("device: %u frames, %u crc errors, %u gaps, %u resyncs\n", stats.frames, stats.crcErrors, stats.seqGaps, stats.resyncs);
+        if (stats.crcErrors != 1 || stats.seqGaps != 1 || stats.resyncs != 2) {
+            printf("NG: unexpected device statistics\n");
+            errors++;
+        }
+    } else {
+        for (int i = 0; i < 100; i++) {
+            char aryText[17];
+            snprintf(aryText, sizeof(aryText), "COUNT: %5d", i);
+            lcd_RemoteHostWrite(&host, 1, 0, aryText, -1);
+            lcd_RemoteHostFlush(&host);
+            lcd_RemoteHostPoll(&host);
+            usleep(100000);
+        }
+    }
+    printf("total: %u frames, %u bytes, %u resyncs\n", host.frames, host.bytes, host.resyncs);
+    if (isLoopback) printf(errors == 0 ? "OK\n" : "NG: %d errors\n", errors);
+    return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file LCDModelStub.cpp
+ * @author Hisayuki Nomura
+ * @brief PC上でリモート表示（i2cLCDRemote.cpp）を確認するための、表示内容のモデルの代わりの関数。\n
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details i2cLCDRemote.cppが呼び出す関数だけを用意し、書き込まれた内容を配列に記録する。液晶には何も送信しない。
+ */
+#include <string.h>
+#include "pico/stdlib.h"
+#include "i2cLCD.h"
+#include "LCDModelStub.h"
+
+/// @brief 書き込まれたDDRAMの内容
+static uint8_t aryStubCell[MAX_LINES][DDRAM_CHARS];
+/// @brief 書き込まれたアイコンの値
+static uint8_t aryStubIcon[16];
+/// @brief 書き込まれたCGRAMの内容
+static uint8_t aryStubCGRAM[64];
+/// @brief カーソルの行
+static int stubCursorLine = 0;
+/// @brief カーソルのカラム
+static int stubCursorColumn = 0;
+/// @brief カーソルを表示している場合はtrue
+static bool isStubCursorShown = false;
+/// @brief lcd_CursorMode()で指定された下線か点滅がある場合はtrue
+static bool isStubCursorMode = false;
+
+/**
+ * @brief 記録した内容を、空白の画面に戻す。
+ */
+void stub_ModelReset(void)
+{
+    memset(aryStubCell, ' ', sizeof(aryStubCell));
+    memset(aryStubIcon, 0, sizeof(aryStubIcon));
+    memset(aryStubCGRAM, 0, sizeof(aryStubCGRAM));
+    stubCursorLine = 0;
+    stubCursorColumn = 0;
+    isStubCursorShown = false;
+    isStubCursorMode = false;
+}
+/**
+ * @brief 書き込まれたセルの内容を取得する。
+ *
+ * @param line 行
+ * @param column DDRAMのカラム
+ * @return uint8_t 文字コード
+ */
+uint8_t stub_ModelCell(int line, int column)
+{
+    return aryStubCell[line][column];
+}
+/**
+ * @brief 書き込まれたアイコンの値を取得する。
+ *
+ * @param iconAddr アイコンのアドレス（０～15）
+ * @return uint8_t 値（下位５ビット）
+ */
+uint8_t stub_ModelIcon(int iconAddr)
+{
+    return aryStubIcon[iconAddr & 0x0F];
+}
+/**
+ * @brief 書き込まれた外字のパターンを取得する。
+ *
+ * @param code 文字コード（０～７）
+ * @return const uint8_t* ８バイトのパターン
+ */
+const uint8_t *stub_ModelGlyph(int code)
+{
+    return &aryStubCGRAM[(code & 0x07) * 8];
+}
+/**
+ * @brief カーソルの位置と、表示しているかを取得する。
+ *
+ * @param pLine 行を入れる
+ * @param pColumn カラムを入れる
+ * @return bool カーソルを表示している場合はtrue
+ */
+bool stub_ModelCursor(int *pLine, int *pColumn)
+{
+    *pLine = stubCursorLine;
+    *pColumn = stubCursorColumn;
+    return isStubCursorShown;
+}
+
+int lcd_ModelWrite(int line, int column, const char *s, int length)
+{
+    if (line < 0 || line >= MAX_LINES || column < 0 || column >= DDRAM_CHARS) return -1;
+    if (length > DDRAM_CHARS - column) length = DDRAM_CHARS - column;
+    memcpy(&aryStubCell[line][column], s, length);
+    return length;
+}
+#if LCD_ICONEXIST
+int lcd_ModelIconSet(bool isDisp, LCD_ICON icon)
+{
+    uint8_t iconAddr = (icon >> 8) & 0x0F;
+    if (isDisp) {
+        aryStubIcon[iconAddr] |= (uint8_t)(icon & 0x1F);
+    } else {
+        aryStubIcon[iconAddr] &= (uint8_t)~(icon & 0x1F);
+    }
+    return 0;
+}
+#endif
+int lcd_CGRAMWrite(uint8_t cgAddr, const uint8_t *aryPattern, int size)
+{
+    if (cgAddr >= 64 || size <= 0) return -1;
+    if (size > 64 - cgAddr) size = 64 - cgAddr;
+    memcpy(&aryStubCGRAM[cgAddr], aryPattern, size);
+    return size + 3;
+}
+int lcd_CursorMode(bool isDisplayOn, bool isUnderLine, bool isBlink)
+{
+    isStubCursorMode = isUnderLine || isBlink;
+    isStubCursorShown = isStubCursorMode;
+    return 0;
+}
+int lcd_CursorDisplay(bool isDisp)
+{
+    isStubCursorShown = isDisp && isStubCursorMode;
+    return 0;
+}
+int lcd_CursorPosition(int line, int position)
+{
+    stubCursorLine = line;
+    stubCursorColumn = position;
+    return 0;
+}
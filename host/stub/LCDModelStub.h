@@ -0,0 +1,25 @@
+/**
+ * @file LCDModelStub.h
+ * @author Hisayuki Nomura
+ * @brief PC上でリモート表示（i2cLCDRemote.cpp）を確認するための、表示内容のモデルの代わりの関数のヘッダファイル。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details 確認用のプログラムは、このヘッダファイルの関数で、i2cLCDRemote.cppがモデルに書き込んだ内容を調べる。
+ */
+#ifndef __LCDModelStub_h__
+#define __LCDModelStub_h__
+
+#include "pico/stdlib.h"
+#include "i2cLCD.h"
+
+void stub_ModelReset(void);
+uint8_t stub_ModelCell(int line, int column);
+uint8_t stub_ModelIcon(int iconAddr);
+const uint8_t *stub_ModelGlyph(int code);
+bool stub_ModelCursor(int *pLine, int *pColumn);
+
+#endif
@@ -0,0 +1,170 @@
+/**
+ * @file PicoStub.cpp
+ * @author Hisayuki Nomura
+ * @brief PC上で液晶ライブラリの処理を確認するための、pico SDKの代わりの関数。\n
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details 時刻は仮想の時刻で、I2Cの送信（１バイト９クロック）と、待ちの関数を呼び出したときだけ進む。
+ * アラームは、時刻が進んだときに、その時刻を過ぎたものを呼び出す。
+ */
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "PicoStub.h"
+
+/// @brief 同時に設定できるアラームの数
+#define STUB_ALARM_MAX  4
+
+struct i2c_inst {
+    int dummy;
+};
+static i2c_inst_t stubI2C0, stubI2C1;
+i2c_inst_t *i2c0 = &stubI2C0;
+i2c_inst_t *i2c1 = &stubI2C1;
+
+/**
+ * @brief 設定されているアラーム。
+ */
+struct StubAlarm {
+    alarm_id_t id;
+    uint64_t at;
+    alarm_callback_t callback;
+    void *user_data;
+};
+
+/// @brief 仮想の時刻（μ秒）
+static uint64_t stubNow = 0;
+/// @brief I2Cのボーレート
+static unsigned stubBaud = 100 * 1000;
+/// @brief 送信したトランザクションの数
+static uint32_t stubWrites = 0;
+/// @brief 最後に送信したトランザクション
+static uint8_t aryStubLast[STUB_I2C_RECORD_MAX];
+/// @brief 最後に送信したトランザクションの長さ
+static int stubLastLength = 0;
+/// @brief 設定されているアラーム。idが０の場合は空き。
+static StubAlarm aryStubAlarm[STUB_ALARM_MAX];
+/// @brief 次に割り当てるアラームのID
+static alarm_id_t stubNextAlarm = 1;
+
+/**
+ * @brief 仮想の時刻を進め、過ぎたアラームを呼び出す。
+ *
+ * @param us 進める時間（μ秒）
+ */
+void stub_TimeAdvance(uint64_t us)
+{
+    uint64_t target = stubNow + us;
+    while (true) {
+        int next = -1;
+        for (int i = 0; i < STUB_ALARM_MAX; i++) {
+            if (aryStubAlarm[i].id != 0 && aryStubAlarm[i].at <= target && (next < 0 || aryStubAlarm[i].at < aryStubAlarm[next].at)) {
+                next = i;
+            }
+        }
+        if (next < 0) break;
+        StubAlarm alarm = aryStubAlarm[next];
+        aryStubAlarm[next].id = 0;
+        if (alarm.at > stubNow) stubNow = alarm.at;
+        int64_t again = alarm.callback(alarm.id, alarm.user_data);
+        if (again > 0) add_alarm_at(stubNow + again, alarm.callback, alarm.user_data, true);
+    }
+    if (target > stubNow) stubNow = target;
+}
+/**
+ * @brief I2Cで送信したトランザクションの数を取得する。
+ *
+ * @return uint32_t i2c_write_blocking()が呼び出された回数
+ */
+uint32_t stub_I2CWriteCount(void)
+{
+    return stubWrites;
+}
+/**
+ * @brief 最後に送信したトランザクションを取得する。
+ *
+ * @param ppData トランザクションのバイト列を指すポインタを入れる
+ * @return int トランザクションの長さ。STUB_I2C_RECORD_MAXを超えた部分は記録されない。
+ */
+int stub_I2CLastWrite(const uint8_t **ppData)
+{
+    *ppData = aryStubLast;
+    return stubLastLength;
+}
+
+uint64_t time_us_64(void)
+{
+    return stubNow;
+}
+void sleep_us(uint64_t us)
+{
+    stub_TimeAdvance(us);
+}
+void sleep_ms(uint32_t ms)
+{
+    stub_TimeAdvance((uint64_t)ms * 1000);
+}
+void busy_wait_until(absolute_time_t t)
+{
+    if (t > stubNow) stub_TimeAdvance(t - stubNow);
+}
+bool best_effort_wfe_or_timeout(absolute_time_t t)
+{
+    busy_wait_until(t);
+    return true;
+}
+alarm_id_t add_alarm_at(absolute_time_t t, alarm_callback_t callback, void *user_data, bool fire_if_past)
+{
+    if (t <= stubNow && fire_if_past) {
+        callback(0, user_data);
+        return 0;
+    }
+    for (int i = 0; i < STUB_ALARM_MAX; i++) {
+        if (aryStubAlarm[i].id != 0) continue;
+        aryStubAlarm[i].id = stubNextAlarm++;
+        aryStubAlarm[i].at = t;
+        aryStubAlarm[i].callback = callback;
+        aryStubAlarm[i].user_data = user_data;
+        return aryStubAlarm[i].id;
+    }
+    return -1;
+}
+bool cancel_alarm(alarm_id_t id)
+{
+    for (int i = 0; i < STUB_ALARM_MAX; i++) {
+        if (aryStubAlarm[i].id == id && id != 0) {
+            aryStubAlarm[i].id = 0;
+            return true;
+        }
+    }
+    return false;
+}
+void gpio_set_function(unsigned gpio, int fn)
+{
+}
+void gpio_pull_up(unsigned gpio)
+{
+}
+unsigned i2c_init(i2c_inst_t *i2c, unsigned baudrate)
+{
+    stubBaud = baudrate;
+    return baudrate;
+}
+unsigned i2c_set_baudrate(i2c_inst_t *i2c, unsigned baudrate)
+{
+    stubBaud = baudrate;
+    return baudrate;
+}
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop)
+{
+    stubWrites++;
+    stubLastLength = (len < STUB_I2C_RECORD_MAX) ? (int)len : STUB_I2C_RECORD_MAX;
+    memcpy(aryStubLast, src, stubLastLength);
+    stub_TimeAdvance(((uint64_t)(len + 1) * 9 + 2) * 1000000 / stubBaud);
+    return (int)len;
+}
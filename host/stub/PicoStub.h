@@ -0,0 +1,25 @@
+/**
+ * @file PicoStub.h
+ * @author Hisayuki Nomura
+ * @brief PC上で液晶ライブラリの処理を確認するための、pico SDKの代わりの関数のヘッダファイル。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details 確認用のプログラムは、このヘッダファイルの関数で、ライブラリが送信したI2Cのトランザクションを調べる。
+ */
+#ifndef __PicoStub_h__
+#define __PicoStub_h__
+
+#include "pico/stdlib.h"
+
+/// @brief 記録しておく、最後のトランザクションの最大の長さ
+#define STUB_I2C_RECORD_MAX 512
+
+uint32_t stub_I2CWriteCount(void);
+int stub_I2CLastWrite(const uint8_t **ppData);
+void stub_TimeAdvance(uint64_t us);
+
+#endif
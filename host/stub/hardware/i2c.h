@@ -0,0 +1,22 @@
+/**
+ * @file i2c.h
+ * @author Hisayuki Nomura
+ * @brief PC上で液晶ライブラリの処理を確認するための、pico SDKのhardware/i2c.hの代わり。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details 送信したトランザクションは、液晶に送る代わりにPicoStub.cppで記録する。
+ */
+#ifndef __PicoStub_i2c_h__
+#define __PicoStub_i2c_h__
+
+#include "pico/stdlib.h"
+
+unsigned i2c_init(i2c_inst_t *i2c, unsigned baudrate);
+unsigned i2c_set_baudrate(i2c_inst_t *i2c, unsigned baudrate);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+
+#endif
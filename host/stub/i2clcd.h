@@ -0,0 +1,11 @@
+/**
+ * @file i2clcd.h
+ * @author Hisayuki Nomura
+ * @brief i2cLCDlocal.hがincludeするファイル名（小文字）を、大文字小文字を区別するファイルシステムでi2cLCD.hにつなぐ。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ */
+#include "i2cLCD.h"
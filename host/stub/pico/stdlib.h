@@ -0,0 +1,50 @@
+/**
+ * @file stdlib.h
+ * @author Hisayuki Nomura
+ * @brief PC上で液晶ライブラリの処理を確認するための、pico SDKのpico/stdlib.hの代わり。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details 液晶ライブラリが使用している型と関数だけを宣言する。時刻は実際の時計ではなく、I2Cの送信や待ちで進む仮想の時刻になる。
+ * 実体はPicoStub.cppにある。
+ */
+#ifndef __PicoStub_stdlib_h__
+#define __PicoStub_stdlib_h__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdarg.h>
+
+/// @brief I2Cのハードウェアブロック。PCでは中身を持たない。
+typedef struct i2c_inst i2c_inst_t;
+extern i2c_inst_t *i2c0;
+extern i2c_inst_t *i2c1;
+
+/// @brief GPIOの機能の番号（I2C）
+#define GPIO_FUNC_I2C   3
+
+typedef uint64_t absolute_time_t;
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+
+uint64_t time_us_64(void);
+static inline uint32_t time_us_32(void) { return (uint32_t)time_us_64(); }
+static inline absolute_time_t from_us_since_boot(uint64_t us) { return us; }
+static inline absolute_time_t get_absolute_time(void) { return time_us_64(); }
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+void busy_wait_until(absolute_time_t t);
+bool best_effort_wfe_or_timeout(absolute_time_t t);
+alarm_id_t add_alarm_at(absolute_time_t t, alarm_callback_t callback, void *user_data, bool fire_if_past);
+bool cancel_alarm(alarm_id_t id);
+static inline void __wfe(void) {}
+static inline void __sev(void) {}
+static inline void tight_loop_contents(void) {}
+void gpio_set_function(unsigned gpio, int fn);
+void gpio_pull_up(unsigned gpio);
+
+#endif
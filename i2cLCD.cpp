@@ -45,6 +45,96 @@
 #undef  i2c_default
 #define i2c_default I2C_PORT
 
+/**
+ * @brief 現在のLCDに対する設定値を保存する構造体の実体。
+ * @details 詳細は、i2cLCDlocal.hのデータ構造を参照。
+ */
+struct LCDSetting lcdSetting;
+
+/**
+ * @brief 液晶コントローラが直前の命令を実行し終わるまで待つ。
+ * @details 命令を送信するたびにsleep_usで待つ代わりに、命令の実行が終わる時刻をlcdSetting.busyUntilに記録しておき、
+ * 次の送信の直前にこの関数で待つ。これにより、ClearDisplayの実行中などに、液晶以外の処理を行うことができる。\n
+ * 待っている間はWFEでCPUを休ませ、休んだ時間をlcdSetting.cpuStats.idleUsに加える。
+ * 液晶への送信は割り込みの中からは行わないので、この関数も常にスレッドから呼び出される。
+ */
+void lcd_WaitReady(void)
+{
+    uint64_t start = time_us_64();
+    if (start >= lcdSetting.busyUntil) return;
+    absolute_time_t until = from_us_since_boot(lcdSetting.busyUntil);
+    while (!best_effort_wfe_or_timeout(until)) {
+        // アラームやほかの割り込みで起こされた場合は、もう一度休む
+    }
+    lcdSetting.cpuStats.idleUs += time_us_64() - start;
+}
+/**
+ * @brief 液晶コントローラがビジーになっている時間を延長する。
+ * 
+ * @param execUs 現在から、液晶コントローラがビジーになっている時間（μ秒）
+ * @details ClearDisplayやReturnHomeのように実行に時間がかかる命令を送信した後に呼び出す。
+ */
+void lcd_ExtendBusy(uint32_t execUs)
+{
+    uint64_t until = time_us_64() + execUs;
+    if (until > lcdSetting.busyUntil) {
+        lcdSetting.busyUntil = until;
+    }
+}
+/**
+ * @brief I2Cの速度を変更する。
+ * 
+ * @param hz I2Cのボーレート（Hz）。ST7032は400KHzまで。
+ * @return uint32_t 実際に設定されたボーレート（Hz）
+ * @details 送信時間の見積もり（lcd_BusTimeUs）にも、設定されたボーレートを使用する。
+ */
+uint32_t lcd_BusSpeedSet(uint32_t hz)
+{
+    lcd_AsyncStop();                            // バックグラウンドの送信中には変更しない
+    lcd_WaitReady();
+    lcdSetting.busHz = i2c_set_baudrate(I2C_PORT, hz);
+    return lcdSetting.busHz;
+}
+/**
+ * @brief I2Cでlengthバイトを送信するのにかかる時間の見積もり。
+ * 
+ * @param length 送信するバイト数（コントロールバイトを含み、スレーブアドレスは含まない）
+ * @return uint32_t 送信にかかる時間（μ秒）
+ * @details １バイトあたり、ACKを含めて９クロック。スレーブアドレスの１バイトと、スタート/ストップコンディションの分を加える。
+ */
+uint32_t lcd_BusTimeUs(int length)
+{
+    uint32_t hz = lcdSetting.busHz ? lcdSetting.busHz : I2C_SPEED;
+    return (uint32_t)((((uint64_t)(length + 1) * 9 + 2) * 1000000 + hz - 1) / hz);
+}
+/**
+ * @brief I2Cで液晶に送信する、すべての送信が通過する最下位の関数。
+ * 
+ * @param buf 送信するデータ。コントロールバイトを含む。
+ * @param length 送信するバイト数
+ * @param execUs 送信後に、液晶コントローラが最後のバイトを実行し終わるまでの時間（μ秒）
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ * @details 前の命令が実行し終わるまで待ってから送信し、送信後は待たずに戻る。待ち時間は次の送信の直前に、lcd_WaitReady()で待つ。\n
+ * 送信したバイト数などの統計もここで集計する。
+ */
+int lcd_BusWrite(const uint8_t *buf, int length, uint32_t execUs)
+{
+    lcd_AsyncStop();                            // 直接の送信は、バックグラウンドの送信を止めてから行う
+    lcd_WaitReady();
+    uint64_t start = time_us_64();
+    int iRet = i2c_write_blocking(I2C_PORT, I2C_ADDRESS, buf, length, false);
+    uint64_t end = time_us_64();
+    lcdSetting.busyUntil = end + execUs;
+    uint32_t busy = (uint32_t)(end - start);
+    lcdSetting.cpuStats.operations++;
+    lcdSetting.cpuStats.busyUs += busy;
+    if (busy > lcdSetting.cpuStats.maxBusyUs) lcdSetting.cpuStats.maxBusyUs = busy;
+    lcdSetting.busStats.transactions++;
+    if (iRet > 0) {
+        lcdSetting.busStats.bytes += iRet;
+    }
+    return iRet;
+}
 
 /**
  * @brief I2Cで１バイトのコマンドを送信する低レベルの関数。\n
@@ -71,9 +161,13 @@ static int i2c_write_byte(uint8_t val,bool nostop)
     t_data[0]=LCD_COMMAND;
     t_data[1]=val;
     volatile int iRet;
-    iRet = i2c_write_blocking(I2C_PORT, I2C_ADDRESS, t_data, 2, nostop);
-
-    sleep_us(CMD_DELAY);
+    if (nostop) {
+        lcd_WaitReady();
+        iRet = i2c_write_blocking(I2C_PORT, I2C_ADDRESS, t_data, 2, nostop);
+        lcd_ExtendBusy(CMD_DELAY);
+    } else {
+        iRet = lcd_BusWrite(t_data, 2, CMD_DELAY);
+    }
     return iRet;
 }
 /**
@@ -119,9 +213,7 @@ static int i2c_write_DataByte(uint8_t cmd, uint8_t val)
     t_data[0]=cmd;
     t_data[1]=val;
     volatile int iRet;
-    iRet = i2c_write_blocking(I2C_PORT, I2C_ADDRESS, t_data, 2, false);
-
-    sleep_us(CMD_DELAY);
+    iRet = lcd_BusWrite(t_data, 2, CMD_DELAY);
     return iRet;
 }
 
@@ -163,22 +255,25 @@ static int i2c_write_DataByte(uint8_t val)
 static int i2c_write_Data(unsigned char *buf, int length) 
 {
     int iByteSent = 0;
-    bool bRet;
-    volatile uint8_t i;
-    uint8_t t_data[MAX_CHARS* MAX_LINES+1];
+    uint8_t t_data[DDRAM_CHARS* MAX_LINES+1];
     size_t len;
     if (length < 0) {
         len = strlen((const char *)buf);
     } else {
         len = length;
     }
-    for (i = 0 ; i < len;i++) {
+    // DDRAM全体より長い場合は、分割して送信する
+    while (len > 0) {
+        size_t chunk = len < sizeof(t_data) - 1 ? len : sizeof(t_data) - 1;
         t_data[0] = LCD_CHARACTER;
-        t_data[i+1] = (uint8_t)buf[i];
+        memcpy(&t_data[1], buf, chunk);
+        volatile int iRet;
+        iRet = lcd_BusWrite(t_data, chunk+1, CMD_DELAY);
+        if (iRet < 0) return iRet;
+        iByteSent += iRet;
+        buf += chunk;
+        len -= chunk;
     }
-    volatile int iRet;
-    iRet = i2c_write_blocking(I2C_PORT , I2C_ADDRESS , t_data, len+1, false);
-    iByteSent += iRet;
     return iByteSent;
 }
 /**
@@ -206,18 +301,152 @@ static int lcd_send_byte(uint8_t val)
     return iRet;
 }  
 
+/**
+ * @brief 複数のコマンドとデータを、１回のトランザクションで送信するためのバッファを初期化する。
+ * 
+ * @param pBatch 初期化するバッファ
+ */
+void lcd_BatchInit(LCDBatch *pBatch)
+{
+    pBatch->length = 0;
+    pBatch->lastCtrl = -1;
+    pBatch->isClosed = false;
+    pBatch->execUs = 0;
+}
+/**
+ * @brief バッファにコマンドを１つ追加する。
+ * 
+ * @param pBatch 追加するバッファ
+ * @param cmd 追加するコマンド
+ * @param execUs コマンドの実行にかかる時間（μ秒）。通常はCMD_DELAY、ClearDisplayなどはCMD_DELAY_LONG。
+ * @return bool 追加できた場合はtrue。バッファが一杯か、lcd_BatchDataRunの後の場合はfalse。
+ * @details ClearDisplayのように実行に時間がかかるコマンドは、続くバイトを受け付けられないので最後に追加すること。
+ */
+bool lcd_BatchCommand(LCDBatch *pBatch, uint8_t cmd, uint32_t execUs)
+{
+    if (pBatch->isClosed || pBatch->length + 2 > LCD_BATCH_MAX) return false;
+    pBatch->lastCtrl = pBatch->length;
+    pBatch->aryData[pBatch->length++] = LCD_CONTINUE | LCD_COMMAND;
+    pBatch->aryData[pBatch->length++] = cmd;
+    pBatch->execUs = execUs;
+    return true;
+}
+/**
+ * @brief バッファに、データ（文字やCGRAM、アイコンの値）を１バイト追加する。
+ * 
+ * @param pBatch 追加するバッファ
+ * @param val 追加するデータ
+ * @return bool 追加できた場合はtrue
+ * @details １バイトごとにコントロールバイトが必要なので、連続したデータの場合はlcd_BatchDataRunを使用したほうが効率が良い。
+ */
+bool lcd_BatchDataByte(LCDBatch *pBatch, uint8_t val)
+{
+    if (pBatch->isClosed || pBatch->length + 2 > LCD_BATCH_MAX) return false;
+    pBatch->lastCtrl = pBatch->length;
+    pBatch->aryData[pBatch->length++] = LCD_CONTINUE | LCD_CHARACTER;
+    pBatch->aryData[pBatch->length++] = val;
+    pBatch->execUs = CMD_DELAY;
+    return true;
+}
+/**
+ * @brief バッファに、連続したデータを追加する。
+ * 
+ * @param pBatch 追加するバッファ
+ * @param buf 追加するデータ
+ * @param length データの長さ
+ * @return bool 追加できた場合はtrue
+ * @details 連続したデータはトランザクションの最後にしか置けないので、この関数を呼んだ後は何も追加できない。
+ */
+bool lcd_BatchDataRun(LCDBatch *pBatch, const uint8_t *buf, int length)
+{
+    if (pBatch->isClosed || pBatch->length + 1 + length > LCD_BATCH_MAX) return false;
+    pBatch->lastCtrl = pBatch->length;
+    pBatch->aryData[pBatch->length++] = LCD_CHARACTER;
+    memcpy(&pBatch->aryData[pBatch->length], buf, length);
+    pBatch->length += length;
+    pBatch->isClosed = true;
+    pBatch->execUs = CMD_DELAY;
+    return true;
+}
+/**
+ * @brief バッファにためたコマンドとデータを、１回のI2Cトランザクションで送信する。
+ * 
+ * @param pBatch 送信するバッファ
+ * @return int 送信したバイト数。負の値の場合はエラー。何も入っていない場合は０。
+ */
+int lcd_BatchSend(LCDBatch *pBatch)
+{
+    if (pBatch->lastCtrl < 0) return 0;
+    // 最後のコントロールバイトは、Coビットを落として「これで終わり」にする
+    pBatch->aryData[pBatch->lastCtrl] &= ~LCD_CONTINUE;
+    return lcd_BusWrite(pBatch->aryData, pBatch->length, pBatch->execUs);
+}
+
+/**
+ * @brief 行とカラムから、DDRAMのアドレスを求める。
+ * 
+ * @param line 行（0～1）
+ * @param column カラム（0～DDRAM_CHARS-1）
+ * @return uint8_t DDRAMのアドレス。１行目は0x00から、２行目は0x40から始まる。
+ */
+uint8_t lcd_DDRAMAddr(int line, int column)
+{
+    return (line == 0 ? 0x00 : 0x40) | (LCDCommands.DDRAMOpt.LCD_SETDDRAM_MASK & column);
+}
+/**
+ * @brief DDRAMにlengthバイト書き込んだ（カーソルを動かした）後のアドレスを求める。
+ * 
+ * @param addr 書き込む前のアドレス
+ * @param length 書き込んだバイト数。負の値の場合は左に移動した数。
+ * @return uint8_t 書き込んだ後のアドレス
+ * @details ２行モードでは、１行目の最後(0x27)の次は２行目の先頭(0x40)、２行目の最後(0x67)の次は１行目の先頭になる。
+ */
+static uint8_t lcd_AdvanceAddr(uint8_t addr, int length)
+{
+    int pos = ((addr & 0x40) ? DDRAM_CHARS : 0) + (addr & 0x3F);
+    pos = ((pos + length) % (DDRAM_CHARS * 2) + DDRAM_CHARS * 2) % (DDRAM_CHARS * 2);
+    return lcd_DDRAMAddr(pos / DDRAM_CHARS, pos % DDRAM_CHARS);
+}
+/**
+ * @brief 液晶コントローラのアドレスカウンタを、ライブラリが覚えているカーソル位置に合わせる。
+ * 
+ * @return int 送信したバイト数。アドレスが一致していて送信の必要がない場合は０。
+ * @details lcd_Flush()などは、カーソル位置とは関係のない場所に書き込むので、アドレスカウンタとカーソル位置がずれる。
+ * 文字列を表示する前にこの関数を呼び出して、カーソル位置に戻す。
+ */
+static int lcd_SyncCursor(void)
+{
+    if (lcdSetting.hwAddr == lcd_DDRAMAddr(lcdSetting.curPosLine, lcdSetting.curPosColumn)) {
+        return 0;
+    }
+    return lcd_CursorAddrSet(lcdSetting.curPosLine, lcdSetting.curPosColumn);
+}
+
 
 
 /**
  * @brief 液晶に表示されているテキストを消去する
  * return int 送信したバイト数。-1の場合はエラー。2が正常（LCD_CHARACTER＋valで２バイト）
- * @details 液晶の表示メモリ（Dispray Data RAM…DDRAM)を0x20で埋め、カーソル位置を画面左上（Address Control…AC を０）に設定する。
+ * @details 液晶の表示メモリ（Dispray Data RAM…DDRAM)を0x20で埋め、カーソル位置を画面左上（Address Control…AC を０）に設定する。\n
+ * フレームレートを制限している場合（lcd_FrameRateSet）や、lcd_begin()のトランザクションの中では、表示内容のモデルを空白にしてカーソル位置を左上にするだけで、何も送信しない。
+ * この場合、lcd_DisplayShift()でずらした表示位置は元に戻らない。
  */
 int lcd_ClearDisplay(void) 
 {
+    if (lcd_IsBuffered()) {
+        lcd_ModelClear();
+        lcdSetting.curPosLine = 0;
+        lcdSetting.curPosColumn = 0;
+        return 0;
+    }
     //int iRet = lcd_send_byte(LCD_CLEARDISPLAY);
     int iRet = lcd_send_byte(LCDCommands.CLEARDISPLAY);
-    sleep_us(CMD_DELAY_LONG);
+    lcd_ExtendBusy(CMD_DELAY_LONG);
+    lcdSetting.hwAddr = 0;
+    lcdSetting.displayShift = 0;
+    lcdSetting.curPosLine = 0;
+    lcdSetting.curPosColumn = 0;
+    lcd_ModelMirrorClear();
     return iRet;
 }
 
@@ -225,14 +454,24 @@ int lcd_ClearDisplay(void)
  * @brief DDRAMアドレスを00Hに設定しカーソルをもとに戻す。表示内容は変更されない。右⇒左モードの場合、カーソル位置は１行目の右端にセットされる
  * 
  * @return int 送信したバイト数。負の値の場合はエラー。
+ * @details フレームレートを制限している場合（lcd_FrameRateSet）や、lcd_begin()のトランザクションの中では、カーソル位置を戻すだけで何も送信しない。
  */
 int lcd_ReturnHome(void)
 {
+    if (lcd_IsBuffered()) {
+        lcdSetting.curPosLine = 0;
+        lcdSetting.curPosColumn = lcdSetting.isDisplayToLeft ? MAX_CHARS - 1 : 0;
+        return 0;
+    }
     int iRet = lcd_send_byte(LCDCommands.RETURNHOME);
+    lcd_ExtendBusy(CMD_DELAY_LONG);
+    lcdSetting.hwAddr = 0;
+    lcdSetting.displayShift = 0;
+    lcdSetting.curPosLine = 0;
+    lcdSetting.curPosColumn = 0;
     if (lcdSetting.isDisplayToLeft) {
-        lcd_CursorPosition(0,MAX_CHARS-1);
+        lcd_CursorAddrSet(0,MAX_CHARS-1);
     }
-    sleep_us(CMD_DELAY_LONG);
     return iRet;    
 }
 /**
@@ -261,10 +500,29 @@ int lcd_EntryModeSet(bool a_isDisplayToLeft)
  * @param line 表示する行　（0～１）
  * @param position 表示するカラム（０～１５）
  * @return int 送信したバイト数。-1の場合はエラー。2が正常（LCD_CHARACTER＋valで２バイト）
- * @details ST7032では、文字を表示するためのメモリは、１行目が0x00から、２行目は0x40から始まる。
- * このプログラムは少し冗長だが、可読性を優先した。
+ * @details ST7032では、文字を表示するためのメモリは、１行目が0x00から、２行目は0x40から始まる。\n
+ * フレームレートを制限している場合（lcd_FrameRateSet）や、lcd_begin()のトランザクションの中では、カーソル位置を覚えるだけで何も送信せず、０を返す。
+ * 表示されているカーソルは、次のフレームの送信の最後に移動する。
  */
 int lcd_CursorPosition(int line, int position) 
+{
+    if (lcd_IsBuffered()) {
+        lcdSetting.curPosLine = line;
+        lcdSetting.curPosColumn = position;
+        return 0;
+    }
+    return lcd_CursorAddrSet(line, position);
+}
+/**
+ * @brief 液晶のカーソル位置を指定し、アドレス設定のコマンドを必ず送信する。
+ * 
+ * @param line 表示する行　（0～１）
+ * @param position 表示するカラム（０～１５）
+ * @return int 送信したバイト数。-1の場合はエラー。
+ * @details lcd_CursorPosition()と異なり、フレームレートを制限している場合やトランザクションの中でも送信する。lcd_Flush()などで、カーソルを元の位置に戻すときに使用する。
+ * このプログラムは少し冗長だが、可読性を優先した。
+ */
+int lcd_CursorAddrSet(int line, int position)
 {
     int val = LCDCommands.SETDDRAMADDR;
     if (line == 0) {
@@ -275,6 +533,7 @@ int lcd_CursorPosition(int line, int position)
     int iRet = lcd_send_byte(val);
     lcdSetting.curPosLine = line;
     lcdSetting.curPosColumn = position;
+    lcdSetting.hwAddr = val & LCDCommands.DDRAMOpt.LCD_SETDDRAM_MASK;
 
     return iRet;
 }
@@ -329,6 +588,22 @@ int lcd_2LineMode(bool is2Line)
 }
 
 
+/**
+ * @brief 現在の設定のまま、命令セットだけを切り替えるFUNCTIONSETコマンドの値を求める。
+ * 
+ * @param isExtInstruction trueのときは拡張モード(IS=1)、falseのときは標準モード(IS=0)
+ * @return uint8_t FUNCTIONSETコマンドの値
+ * @details lcd_BatchCommandなどで、他のコマンドと一緒に命令セットを切り替えるときに使用する。lcdSettingは変更しない。
+ */
+uint8_t lcd_FunctionSetCmd(bool isExtInstruction)
+{
+    uint8_t val = LCDCommands.FUNCTIONSET;
+    val |= isExtInstruction ? LCDCommands.FuncSetOpt.INSTRUCTIONTABLE:0;
+    val |= lcdSetting.isFunc_2LINE ? LCDCommands.FuncSetOpt.DOUBLELINE:0;
+    val |= lcdSetting.isFunc_DoubleHeight ? LCDCommands.FuncSetOpt.DOUBLEHEIGHT:0;
+    val |= lcdSetting.isFunc_8Bit ? LCDCommands.FuncSetOpt.EIGHTBITMODE:0;
+    return val;
+}
 /**
  * @brief 命令セットを標準モード（LCD_FUNCTIONSETの、LCD_FUNC_INSTTBL_SELECTを０）にする。\n
  *  lcd_FunctionSetで指定した、ほかの設定値は変更されない。
@@ -462,6 +737,33 @@ int lcd_CursorDisplay(bool isDisp)
     return iRet;
 }
 
+/**
+ * @brief 現在のカーソル位置から、表示内容のモデルに書き込み、カーソルを進める。
+ * 
+ * @param buf 書き込むデータ
+ * @param length 書き込む長さ
+ * @return int 常に０（何も送信しない）
+ * @details 液晶のアドレスカウンタと同じように、行の最後(DDRAM_CHARS)を超えると次の行の先頭に折り返す。
+ */
+static int lcd_StringToModel(const uint8_t *buf, int length)
+{
+    uint8_t addr = lcd_DDRAMAddr(lcdSetting.curPosLine, lcdSetting.curPosColumn);
+    while (length > 0) {
+        int line = (addr & 0x40) ? 1 : 0;
+        int column = addr & 0x3F;
+        int count = DDRAM_CHARS - column;
+        if (count > length) count = length;
+        if (line < MAX_LINES) {
+            lcd_ModelWrite(line, column, (const char *)buf, count);
+        }
+        addr = lcd_AdvanceAddr(addr, count);
+        buf += count;
+        length -= count;
+    }
+    lcdSetting.curPosLine = (addr & 0x40) ? 1 : 0;
+    lcdSetting.curPosColumn = addr & 0x3F;
+    return 0;
+}
 /**
  * @brief 現在のカーソル位置に、指定された文字列(NULL終了）を表示する
  * 
@@ -470,9 +772,7 @@ int lcd_CursorDisplay(bool isDisp)
  */
 int lcd_string(const char *s) 
 {
-    int iRet = i2c_write_Data((unsigned char *)s);
-    lcdSetting.curPosColumn += strlen(s);
-    return iRet;
+    return lcd_string(s, strlen(s));
 }
 /**
  * @brief 現在のカーソル位置に、指定された長さのバッファを表示する。ヌル文字も出力できる。
@@ -480,12 +780,33 @@ int lcd_string(const char *s)
  * @param s 表示する文字列
  * @param length 出力する長さ
  * @return int 送信したバイト数。-1の場合はエラー。それ以外の正の値は正常。
+ * @details 書き込んだ内容は、表示内容のモデル（lcd_ModelWriteなどで使用）にも反映される。\n
+ * フレームレートを制限している場合（lcd_FrameRateSet）や、lcd_begin()のトランザクションの中では、液晶には送信せず、モデルに書き込んでカーソルを進めるだけで０を返す。
+ * 次のフレームまでに同じ場所に何度書き込んでも、送信されるのは最後に書き込んだ内容だけになる。
  */
 int lcd_string(const char *s , int length) 
 {
-    int iRet = i2c_write_Data((unsigned char *)s,length);
-    lcdSetting.curPosColumn += strlen(s);
-    return iRet;
+    int iSendBytes = 0;
+    if (length < 0) {
+        length = strlen(s);
+    }
+    if (lcd_IsBuffered() && !lcdSetting.isDisplayToLeft) {
+        return lcd_StringToModel((const uint8_t *)s, length);
+    }
+    int iRet = lcd_SyncCursor();
+    if (iRet < 0) return iRet;
+    iSendBytes += iRet;
+    iRet = i2c_write_Data((unsigned char *)s,length);
+    if (iRet < 0) return iRet;
+    iSendBytes += iRet;
+    lcd_ModelMirror(lcdSetting.curPosLine, lcdSetting.curPosColumn, (const uint8_t *)s, length);
+    if (lcdSetting.isDisplayToLeft) {           // 書き込むたびに、表示全体が１文字ずつ左にシフトしている
+        lcdSetting.displayShift = (uint8_t)((lcdSetting.displayShift + length) % DDRAM_CHARS);
+    }
+    lcdSetting.hwAddr = lcd_AdvanceAddr(lcdSetting.hwAddr, length);
+    lcdSetting.curPosLine = (lcdSetting.hwAddr & 0x40) ? 1 : 0;
+    lcdSetting.curPosColumn = lcdSetting.hwAddr & 0x3F;
+    return iSendBytes;
 }
 
 /**
@@ -502,7 +823,7 @@ void lcd_printf(const char *format, ...)
     va_list va;
     va_start(va , format);
     vsnprintf(aryLCDBuf,sizeof(aryLCDBuf),format , va);
-    lcdSetting.curPosColumn += strlen(aryLCDBuf);
+    va_end(va);
     lcd_string(aryLCDBuf);
 }
 
@@ -612,10 +933,17 @@ int lcd_IconSetRAW(bool isDisp , uint8_t iconAddr , uint8_t bits)
     iRet = i2c_write_DataByte(curValue);
     iSendBytes += iRet;
     lcdSetting.aryIconValue[iconAddr] = curValue;
+    lcd_ModelMirrorIcon(iconAddr, bits, isDisp);
+    lcdSetting.hwAddr = 0xFF;               // アドレスカウンタはアイコンのアドレスを指している
     iRet = lcd_NormalMode();
     iSendBytes += iRet;
+    uint8_t curPosLine = lcdSetting.curPosLine;
+    uint8_t curPosColumn = lcdSetting.curPosColumn;
     iRet = lcd_ReturnHome();                // ICONの設定をした後は、これ（lcd_cursorでもよい）を実行しないとNormalモードに戻らない？
     iSendBytes += iRet;
+    // ReturnHomeでカーソル位置が(0,0)になるが、利用者が指定したカーソル位置は変えない。次の文字列表示の前に戻される。
+    lcdSetting.curPosLine = curPosLine;
+    lcdSetting.curPosColumn = curPosColumn;
     return iSendBytes;
 }
 /**
@@ -663,14 +991,20 @@ int lcd_IconSetAll(bool isDisplay)
         for (int i = 0;i<16;i++) {
             lcd_ExtendMode();
             lcdSetting.aryIconValue[i] = 0;
+            lcd_ModelMirrorIcon(i, 0x1F, false);
             iRet = lcd_send_byte(LCDCommands.IS1_SETICON | i);
             iSendBytes += iRet;
             iRet = i2c_write_DataByte(0);
             iSendBytes += iRet;
             lcd_NormalMode();
         }
+        lcdSetting.hwAddr = 0xFF;
     }
+    uint8_t curPosLine = lcdSetting.curPosLine;
+    uint8_t curPosColumn = lcdSetting.curPosColumn;
     lcd_ReturnHome();
+    lcdSetting.curPosLine = curPosLine;
+    lcdSetting.curPosColumn = curPosColumn;
     
     
     return iSendBytes;
@@ -698,10 +1032,22 @@ int lcd_DisplayShift(int8_t ShiftCnt)
     } else {
         moveOpt |= (LCDCommands.CurDispShiftOpt.DISPLAY_RIGHT | LCDCommands.CurDispShiftOpt.CURSOR_RIGHT);
     }
+    // シフト命令は、まとめて１回のトランザクションで送信する。バッファに入りきらない場合は分けて送る
+    LCDBatch batch;
+    lcd_BatchInit(&batch);
     for (int8_t i=0;i<movecnt;i++) {
-        iRet = lcd_send_byte(LCDCommands.IS0_CURDISPSHIFT | moveOpt);
-        iSendBytes += iRet;
+        if (!lcd_BatchCommand(&batch, LCDCommands.IS0_CURDISPSHIFT | moveOpt, CMD_DELAY)) {
+            iRet = lcd_BatchSend(&batch);
+            if (iRet < 0) return iRet;
+            iSendBytes += iRet;
+            lcd_BatchInit(&batch);
+            lcd_BatchCommand(&batch, LCDCommands.IS0_CURDISPSHIFT | moveOpt, CMD_DELAY);
+        }
     }
+    iRet = lcd_BatchSend(&batch);
+    if (iRet < 0) return iRet;
+    iSendBytes += iRet;
+    lcdSetting.displayShift = (uint8_t)((lcdSetting.displayShift - ShiftCnt + DDRAM_CHARS * 4) % DDRAM_CHARS);
     return iSendBytes;
 }
 /**
@@ -714,6 +1060,14 @@ int lcd_MoveCursor(int8_t MoveCnt)
 {
     int iSendBytes = 0;
     int iRet;
+    if (lcd_IsBuffered()) {       // フレームレートの制限やトランザクションの中では、カーソル位置を覚えるだけ
+        uint8_t addr = lcd_AdvanceAddr(lcd_DDRAMAddr(lcdSetting.curPosLine, lcdSetting.curPosColumn), MoveCnt);
+        lcdSetting.curPosLine = (addr & 0x40) ? 1 : 0;
+        lcdSetting.curPosColumn = addr & 0x3F;
+        return 0;
+    }
+    iRet = lcd_SyncCursor();
+    iSendBytes += iRet;
     int8_t movecnt = abs(MoveCnt);
     uint8_t moveOpt = 0;
     if (MoveCnt <0) {
@@ -725,6 +1079,9 @@ int lcd_MoveCursor(int8_t MoveCnt)
         iRet = lcd_send_byte(LCDCommands.IS0_CURDISPSHIFT | moveOpt);
         iSendBytes += iRet;
     }
+    lcdSetting.hwAddr = lcd_AdvanceAddr(lcdSetting.hwAddr, MoveCnt);
+    lcdSetting.curPosLine = (lcdSetting.hwAddr & 0x40) ? 1 : 0;
+    lcdSetting.curPosColumn = lcdSetting.hwAddr & 0x3F;
     return iSendBytes;
 
 }
@@ -781,6 +1138,8 @@ int lcd_CGRAMSet(uint8_t charNo , uint8_t *aryPattern, int size)
     // i2c_write_byte((0x40 | addr),true);
     iRet = lcd_send_byte(LCDCommands.IS0_SETCGRAM | (LCDCommands.SetCGRAMOpt.SETCGRAM_MASK & addr));
     iSendBytes+=iRet;
+    lcdSetting.hwAddr = 0xFF;                       // アドレスカウンタはCGRAMを指している
+    lcdSetting.cgramOwner = LCD_CGRAM_OWNER_NONE;
     for (int i=0;i<size;i++) {
         iRet = i2c_write_DataByte(LCD_CHARACTER,*aryPattern);
         iSendBytes+=iRet;
@@ -789,7 +1148,40 @@ int lcd_CGRAMSet(uint8_t charNo , uint8_t *aryPattern, int size)
     // カーソル表示を元に戻す
     iRet = lcd_CursorMode(lcdSetting.isDisplayOn , lcdSetting.isUnderLine,lcdSetting.isBlink);
     iSendBytes+=iRet;
-    lcd_CursorPosition(lcdSetting.curPosLine,lcdSetting.curPosColumn);
+    lcd_CursorAddrSet(lcdSetting.curPosLine,lcdSetting.curPosColumn);
+    return iSendBytes;
+}
+/**
+ * @brief CGRAMの連続した領域に、パターンを１回のトランザクションでまとめて書き込む
+ * 
+ * @param cgAddr 書き込みを始めるCGRAMのアドレス（０～６３）。文字番号×８＋行になる。
+ * @param aryPattern 書き込むパターン。各バイトの下位５ビットが１行分になる。
+ * @param size 書き込むバイト数。CGRAMの最後（アドレス６３）を超える分は書き込まない。
+ * @return int i2cで送信したバイト数。-1のときはエラー
+ * @details lcd_CGRAMSet()は１バイトごとにトランザクションを分けるので、外字１文字でも１０回以上のトランザクションになる。
+ * この関数は、SETCGRAMのコマンドと続くデータを１回で送信する。複数の外字を続けて書き込むこともできる。\n
+ * アドレスカウンタはCGRAMを指したままになるので、カーソルを表示している場合だけ、カーソルの位置を設定し直す。
+ */
+int lcd_CGRAMWrite(uint8_t cgAddr, const uint8_t *aryPattern, int size)
+{
+    uint8_t t_data[3 + 64];
+    if (cgAddr >= 64 || size <= 0) return -1;
+    if (size > 64 - cgAddr) {
+        size = 64 - cgAddr;
+    }
+    t_data[0] = LCD_CONTINUE | LCD_COMMAND;
+    t_data[1] = LCDCommands.IS0_SETCGRAM | (LCDCommands.SetCGRAMOpt.SETCGRAM_MASK & cgAddr);
+    t_data[2] = LCD_CHARACTER;
+    memcpy(&t_data[3], aryPattern, size);
+    int iSendBytes = lcd_BusWrite(t_data, size + 3, CMD_DELAY);
+    if (iSendBytes < 0) return iSendBytes;
+    lcdSetting.hwAddr = 0xFF;                       // アドレスカウンタはCGRAMを指している
+    lcdSetting.cgramOwner = LCD_CGRAM_OWNER_NONE;
+    if (lcdSetting.isCursorDisplay) {
+        int iRet = lcd_CursorAddrSet(lcdSetting.curPosLine,lcdSetting.curPosColumn);
+        if (iRet < 0) return iRet;
+        iSendBytes += iRet;
+    }
     return iSendBytes;
 }
 
@@ -812,6 +1204,7 @@ void lcd_init()
     // 設定保存領域の初期化
     lcdSetting.isFunc_ISMode = false;
     lcdSetting.isFunc_2LINE = true;
+    lcdSetting.cgramOwner = LCD_CGRAM_OWNER_NONE;
     lcdSetting.isFunc_DoubleHeight = false;
     lcdSetting.isFunc_8Bit = true;
     lcdSetting.isDisplayToLeft = false;
@@ -828,6 +1221,11 @@ void lcd_init()
     lcdSetting.OSCFreq = 0x04;
     lcdSetting.curPosLine = 0;
     lcdSetting.curPosColumn = 0;
+    lcdSetting.hwAddr = 0xFF;
+    lcdSetting.busHz = I2C_SPEED;
+    lcdSetting.busStats.transactions = 0;
+    lcdSetting.busStats.bytes = 0;
+    memset(&lcdSetting.cpuStats, 0, sizeof(lcdSetting.cpuStats));
 
     iRet = lcd_send_byte(0x03);
     iRet = lcd_send_byte(0x03);
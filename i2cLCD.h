@@ -60,6 +60,9 @@
 #define MAX_LINES      2
 /// @brief 必要に応じて変更。接続されている液晶の最大カラム数
 #define MAX_CHARS      16
+/// @brief ST7032のDDRAMの１行あたりの文字数。画面に表示されるのは、このうちMAX_CHARS文字分だけ。
+/// @details 表示されていない部分にも文字を書き込んでおくことができ、lcd_DisplayShiftなどで表示させることができる。
+#define DDRAM_CHARS    40
 /// @brief デフォルトのコントラスト。init()内で最初に設定されるコントラスト。
 /// @details Strawberry LinuxのSB1602Bでは0x28位がちょっと濃い目だが良い感じ、
 /// 秋月のAQM0802＋PCA9515の場合は0x18位で良い感じ。(私感)
@@ -86,6 +89,112 @@
  * オシレータクロックを変更したときなどは、この値を調整する。
  */
 #define CMD_DELAY_LONG  1000
+/**
+ * @brief lcd_Flush()などで、未送信のセルを送信するときに、間に挟まった送信済みのセルも一緒に送ってしまう最大の数。
+ * @details 離れた２か所を別々に送ると、アドレス設定のコマンド（２バイト）と、I2Cのトランザクションが１回余分にかかる。
+ * 間にある送信済みのセルが少なければ、まとめて１回で送ってしまったほうが速い。
+ */
+#define LCD_RUN_MERGE_GAP   3
+
+/**
+ * @brief I2Cで液晶に送信した量の統計。lcd_BusStatsGet()で取得する。
+ * @details バイト数はコントロールバイトを含み、I2Cのスレーブアドレスは含まない。
+ */
+struct LCDBusStats {
+    /// @brief I2Cのトランザクション（i2c_write_blockingの呼び出し）の回数
+    uint32_t transactions;
+    /// @brief 送信したバイト数
+    uint32_t bytes;
+};
+
+/**
+ * @brief 表示内容のモデルに書き込むときの優先度。lcd_Flush()などでは、優先度の高いものから送信される。
+ * @details 例えば、アラームの表示をLCD_PRI_URGENTで書き込むと、LCD_PRI_BULKで書き込んだ画面全体の書き換えや、
+ * LCD_PRI_NORMALのアイコンの更新が送信待ちになっていても、それらを追い越して次のトランザクションで送信される。
+ * 追い越しはI2Cのトランザクションの切れ目で行われ、送信中のトランザクションが中断されることは無い。
+ */
+enum LCD_PRIORITY : uint8_t {
+    /// @brief 画面全体の書き換えなど、急がない大量の更新。LCD_BULK_RUN_MAX文字ずつに区切って送信される
+    LCD_PRI_BULK = 0,
+    /// @brief 通常の更新。優先度を指定しない場合はこの優先度になる
+    LCD_PRI_NORMAL = 1,
+    /// @brief アラームなど、すぐに表示しなければならない更新
+    LCD_PRI_URGENT = 2,
+};
+/// @brief 優先度の数
+#define LCD_PRIORITY_COUNT  3
+/// @brief LCD_PRI_BULKの更新を送信するときの、１回のトランザクションの最大文字数。
+/// @details 小さくするほど、優先度の高い更新が待たされる時間が短くなるが、トランザクションの回数が増える。
+#define LCD_BULK_RUN_MAX    8
+/// @brief 点滅（lcd_BlinkSet）の周期の初期値（ミリ秒）。半分の時間ずつ表示と消去を繰り返す。
+#define LCD_BLINK_PERIOD_MS 1000
+
+/**
+ * @brief 優先度ごとの、モデルに書き込まれてから液晶に送信されるまでの待ち時間の統計。lcd_LatencyStatsGet()で取得する。
+ * @details セル（アイコンの場合はアイコンのアドレス）ごとに、最初に書き込まれてから、送信が完了するまでの時間を集計する。
+ */
+struct LCDLatencyStats {
+    /// @brief 送信したセルの数
+    uint32_t count;
+    /// @brief 待ち時間の最大値（μ秒）
+    uint32_t maxUs;
+    /// @brief 待ち時間の合計（μ秒）。countで割ると平均になる
+    uint64_t totalUs;
+};
+
+/**
+ * @brief 液晶の操作で、CPUが動いていた時間と、休んでいた時間の統計。lcd_CpuStatsGet()で取得する。
+ * @details busyUsをoperationsで割ると、１回の送信あたりにCPUを使った時間になる。
+ */
+struct LCDCpuStats {
+    /// @brief 送信したトランザクションの数
+    uint32_t operations;
+    /// @brief I2Cの送信で、CPUが送信の完了を待って動いていた時間の合計（μ秒）
+    uint64_t busyUs;
+    /// @brief １回の送信で、CPUが動いていた時間の最大値（μ秒）
+    uint32_t maxBusyUs;
+    /// @brief 液晶コントローラの実行待ちで、WFEで休んでいた時間の合計（μ秒）
+    uint64_t idleUs;
+    /// @brief lcd_FlushAsync()で、液晶コントローラの実行待ちの間、CPUをほかの処理に明け渡した時間の合計（μ秒）
+    uint64_t deferredUs;
+};
+
+/**
+ * @brief フレームレートの制限(lcd_FrameRateSet)を使用しているときの統計。lcd_FrameStatsGet()で取得する。
+ * @details フレームの間に同じセルが何度書き換えられても、送信されるのはフレームの時点の最後の内容だけになる。
+ * 送信されずに上書きされた書き込みの数がcoalescedになる。
+ */
+struct LCDFrameStats {
+    /// @brief モデルのセルを書き換えた回数（内容が変わらない書き込みは含まない）
+    uint32_t writes;
+    /// @brief 送信される前に、新しい内容で上書きされたセルの数
+    uint32_t coalesced;
+    /// @brief 最後まで送信できたフレームの数
+    uint32_t framesSent;
+    /// @brief 送信し終わる前に次のフレームの時刻になり、最新の内容で置き換えられたフレームの数
+    uint32_t framesDropped;
+};
+
+/**
+ * @brief 表示内容のモデルの上に重ねて表示する矩形（トーストやダイアログなど）。lcd_OverlayInit()で初期化する。
+ * @details オーバーレイの下の内容はモデルに残っているので、lcd_OverlayHide()で消すと、アプリケーションが描き直さなくても元に戻る。
+ */
+struct LCDOverlay {
+    /// @brief 内容（height×widthバイト）。アプリケーションが用意する。
+    char *pCells;
+    /// @brief 左上の行
+    uint8_t line;
+    /// @brief 左上のカラム（DDRAMのカラム）
+    uint8_t column;
+    /// @brief 行数
+    uint8_t height;
+    /// @brief カラム数
+    uint8_t width;
+    /// @brief 表示中の場合はtrue
+    bool isShown;
+    /// @brief 自動的に消える時刻（time_us_64()の値）。０の場合は消えない。
+    uint64_t hideAt;
+};
 
 // アイコンが接続されていない液晶の場合は不要
 #if LCD_ICONEXIST
@@ -139,6 +248,7 @@ int lcd_CursorPosition(int line, int position) ;
 int lcd_CursorMode(bool isDisplayOn , bool isUnderLine , bool isBlink);
 int lcd_CursorDisplay(bool);
 int lcd_CGRAMSet(uint8_t addr , uint8_t *aryPattern, int size);
+int lcd_CGRAMWrite(uint8_t cgAddr, const uint8_t *aryPattern, int size);
 
 // アイコンが接続されていない液晶の場合は不要
 #if LCD_ICONEXIST
@@ -153,6 +263,55 @@ int lcd_DisplayShift(int8_t ShiftCnt);
 int lcd_MoveCursor(int8_t MoveCnt);
 int lcd_Sleep(bool isSleep);
 
+/*表示内容のモデルと、差分の送信*/
+int lcd_ModelWrite(int line, int column, const char *s, int length);
+int lcd_ModelWrite(int line, int column, const char *s, int length, LCD_PRIORITY pri);
+int lcd_ModelFill(int line, int column, char c, int count);
+int lcd_ModelFill(int line, int column, char c, int count, LCD_PRIORITY pri);
+int lcd_ModelClear(void);
+int lcd_ModelRefresh(LCD_PRIORITY pri);
+#if LCD_ICONEXIST
+int lcd_ModelIconSet(bool isDisp, LCD_ICON icon);
+int lcd_ModelIconSet(bool isDisp, LCD_ICON icon, LCD_PRIORITY pri);
+#endif
+uint8_t lcd_ModelGet(int line, int column);
+bool lcd_ModelIsDirty(void);
+int lcd_Flush(void);
+int lcd_flush_step(uint32_t budget_us);
+uint32_t lcd_BusSpeedSet(uint32_t hz);
+void lcd_BusStatsGet(LCDBusStats *pStats);
+void lcd_BusStatsReset(void);
+void lcd_LatencyStatsGet(LCD_PRIORITY pri, LCDLatencyStats *pStats);
+void lcd_LatencyStatsReset(void);
+int lcd_FrameRateSet(uint32_t maxHz);
+int lcd_FrameTick(uint32_t budget_us);
+void lcd_FrameStatsGet(LCDFrameStats *pStats);
+void lcd_FrameStatsReset(void);
+int lcd_FlushAsync(uint32_t budget_us);
+int lcd_FlushAsyncPoll(void);
+bool lcd_FlushAsyncBusy(void);
+void lcd_BusLock(void);
+void lcd_BusUnlock(void);
+void lcd_CpuStatsGet(LCDCpuStats *pStats);
+void lcd_CpuStatsReset(void);
+int lcd_begin(void);
+int lcd_commit(void);
+int lcd_abort(void);
+int lcd_PageFlipMode(bool isOn);
+int lcd_PageWrite(int line, int column, const char *s, int length);
+int lcd_PageClear(void);
+bool lcd_PageReady(void);
+int lcd_PageFlip(void);
+int lcd_OverlayInit(LCDOverlay *pOv, char *pCells, int line, int column, int height, int width);
+int lcd_OverlayWrite(LCDOverlay *pOv, int line, int column, const char *s, int length);
+int lcd_OverlayShow(LCDOverlay *pOv, uint32_t durationMs);
+int lcd_OverlayHide(LCDOverlay *pOv);
+int lcd_BlinkPeriodSet(uint32_t periodMs);
+int lcd_BlinkSet(int line, int column, int length, bool isBlink);
+#if LCD_ICONEXIST
+int lcd_BlinkIconSet(LCD_ICON icon, bool isBlink);
+#endif
+
 /*初期化関連関数*/
 int lcd_IconSetAll(bool isDisplay);
 void lcd_init();                    // 初期化
@@ -0,0 +1,297 @@
+/**
+ * @file i2cLCDAnsi.cpp
+ * @author Hisayuki Nomura
+ * @brief ANSI/VT100のエスケープシーケンスの一部を解釈して、液晶に表示するための処理。\n
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details シリアルなどで受け取った、エスケープシーケンスを含む文字列をそのまま渡すと、カーソルの移動や行の消去を行って表示する。
+ * 解釈するシーケンスは次の通り。それ以外のシーケンスは読み飛ばす。
+ * - ESC[行;列H、ESC[行;列f　カーソルの移動（CUP、１から数える）
+ * - ESC[nA、ESC[nB、ESC[nC、ESC[nD　カーソルの上下左右の移動
+ * - ESC[nK　行の消去（EL。０：カーソルから右、１：カーソルまで、２：行全体）
+ * - ESC[nJ　画面の消去（ED。０：カーソルから後ろ、１：カーソルまで、２：画面全体）
+ * - ESC[s、ESC[u、ESC7、ESC8　カーソル位置の保存と復元
+ * - ESC[?25h、ESC[?25l　カーソルの表示/非表示
+ * - ESC[nm　属性（SGR。４：下線、５：点滅、２４/２５：解除、０：すべて解除）。液晶は文字ごとの属性を持たないので、カーソルの形で表す。
+ * - ESCc　初期化（画面の消去とカーソルを左上へ）
+ *
+ * 文字や消去は表示内容のモデルに書き込み、lcd_AnsiWrite()の１回の呼び出しの分を、トランザクション（lcd_begin/lcd_commit）で
+ * まとめて送信する。同じセルを何度も書き換えても、送信されるのは最後の内容だけになる。
+ *
+ * @code
+ *  static LCDAnsi ansi;
+ *  lcd_AnsiInit(&ansi);
+ *  lcd_AnsiWrite(&ansi, "\x1b[2J\x1b[1;1HTEMP \x1b[2;1H\x1b[K23.5");
+ * @endcode
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "i2cLCD.h"
+#include "i2cLCDlocal.h"
+#include "i2cLCDAnsi.h"
+
+/// @brief 通常の文字を受け取っている状態
+#define LCD_ANSI_TEXT   0
+/// @brief ESCを受け取った直後の状態
+#define LCD_ANSI_ESC    1
+/// @brief CSI(ESC[)のパラメータを受け取っている状態
+#define LCD_ANSI_CSI    2
+
+/**
+ * @brief エスケープシーケンスの解釈の状態を初期化する。画面の内容は変更しない。
+ *
+ * @param pAnsi 初期化する状態
+ * @return int 常に０
+ * @details カーソルは左上、属性はなし、カーソルは表示する状態になる。
+ */
+int lcd_AnsiInit(LCDAnsi *pAnsi)
+{
+    memset(pAnsi, 0, sizeof(LCDAnsi));
+    pAnsi->state = LCD_ANSI_TEXT;
+    pAnsi->isCursorVisible = true;
+    return 0;
+}
+/**
+ * @brief パラメータを取り出す。省略されている場合や０の場合は、既定値を返す。
+ *
+ * @param pAnsi 状態
+ * @param index パラメータの番号
+ * @param def 既定値
+ * @return int パラメータの値
+ */
+static int lcd_AnsiParam(LCDAnsi *pAnsi, int index, int def)
+{
+    if (index >= pAnsi->paramCount || pAnsi->aryParam[index] == 0) return def;
+    return pAnsi->aryParam[index];
+}
+/**
+ * @brief カーソルの位置を、画面の中に収める。
+ *
+ * @param pAnsi 状態
+ * @param line 行
+ * @param column カラム
+ */
+static void lcd_AnsiMoveTo(LCDAnsi *pAnsi, int line, int column)
+{
+    if (line < 0) line = 0;
+    if (line >= MAX_LINES) line = MAX_LINES - 1;
+    if (column < 0) column = 0;
+    if (column >= MAX_CHARS) column = MAX_CHARS - 1;
+    pAnsi->line = line;
+    pAnsi->column = column;
+}
+/**
+ * @brief 下線と点滅の属性を、カーソルの形として液晶に設定する。
+ *
+ * @param pAnsi 状態
+ */
+static void lcd_AnsiApplyCursor(LCDAnsi *pAnsi)
+{
+    lcd_CursorMode(true, pAnsi->isUnderLine, pAnsi->isBlink);
+    if (!pAnsi->isCursorVisible) {
+        lcd_CursorDisplay(false);
+    }
+}
+/**
+ * @brief 受け取ったCSIシーケンスを実行する。
+ *
+ * @param pAnsi 状態
+ * @param final シーケンスの最後の文字
+ */
+static void lcd_AnsiCsi(LCDAnsi *pAnsi, char final)
+{
+    int n = lcd_AnsiParam(pAnsi, 0, 1);
+    int mode = lcd_AnsiParam(pAnsi, 0, 0);
+    // 右端の文字を書いた直後はカラムがMAX_CHARSになっているので、画面の外（裏のページなど）まで消さないように抑える
+    int head = (pAnsi->column < MAX_CHARS) ? pAnsi->column + 1 : MAX_CHARS;
+    switch (final) {
+    case 'H':
+    case 'f':
+        lcd_AnsiMoveTo(pAnsi, lcd_AnsiParam(pAnsi, 0, 1) - 1, lcd_AnsiParam(pAnsi, 1, 1) - 1);
+        break;
+    case 'A':
+        lcd_AnsiMoveTo(pAnsi, pAnsi->line - n, pAnsi->column);
+        break;
+    case 'B':
+        lcd_AnsiMoveTo(pAnsi, pAnsi->line + n, pAnsi->column);
+        break;
+    case 'C':
+        lcd_AnsiMoveTo(pAnsi, pAnsi->line, pAnsi->column + n);
+        break;
+    case 'D':
+        lcd_AnsiMoveTo(pAnsi, pAnsi->line, pAnsi->column - n);
+        break;
+    case 'K':
+        if (mode == 0) {
+            lcd_ModelFill(pAnsi->line, pAnsi->column, ' ', MAX_CHARS - pAnsi->column);
+        } else if (mode == 1) {
+            lcd_ModelFill(pAnsi->line, 0, ' ', head);
+        } else {
+            lcd_ModelFill(pAnsi->line, 0, ' ', MAX_CHARS);
+        }
+        break;
+    case 'J':
+        for (int line = 0; line < MAX_LINES; line++) {
+            if ((mode == 0 && line > pAnsi->line) || (mode == 1 && line < pAnsi->line) || mode == 2) {
+                lcd_ModelFill(line, 0, ' ', MAX_CHARS);
+            } else if (line == pAnsi->line && mode == 0) {
+                lcd_ModelFill(line, pAnsi->column, ' ', MAX_CHARS - pAnsi->column);
+            } else if (line == pAnsi->line && mode == 1) {
+                lcd_ModelFill(line, 0, ' ', head);
+            }
+        }
+        break;
+    case 's':
+        pAnsi->saveLine = pAnsi->line;
+        pAnsi->saveColumn = pAnsi->column;
+        break;
+    case 'u':
+        lcd_AnsiMoveTo(pAnsi, pAnsi->saveLine, pAnsi->saveColumn);
+        break;
+    case 'h':
+    case 'l':
+        if (pAnsi->isPrivate && mode == 25) {
+            pAnsi->isCursorVisible = (final == 'h');
+            pAnsi->isCursorDirty = true;
+        }
+        break;
+    case 'm': {
+        int count = (pAnsi->paramCount == 0) ? 1 : pAnsi->paramCount;
+        for (int i = 0; i < count; i++) {
+            int attr = lcd_AnsiParam(pAnsi, i, 0);
+            if (attr == 0) {
+                pAnsi->isUnderLine = false;
+                pAnsi->isBlink = false;
+            } else if (attr == 4 || attr == 24) {
+                pAnsi->isUnderLine = (attr == 4);
+            } else if (attr == 5 || attr == 25) {
+                pAnsi->isBlink = (attr == 5);
+            }
+        }
+        pAnsi->isCursorDirty = true;
+        break;
+    }
+    default:
+        break;
+    }
+}
+/**
+ * @brief １文字を受け取り、状態を進める。
+ *
+ * @param pAnsi 状態
+ * @param c 受け取った文字
+ */
+static void lcd_AnsiPut(LCDAnsi *pAnsi, char c)
+{
+    switch (pAnsi->state) {
+    case LCD_ANSI_ESC:
+        pAnsi->state = LCD_ANSI_TEXT;
+        if (c == '[') {
+            pAnsi->state = LCD_ANSI_CSI;
+            pAnsi->isPrivate = false;
+            pAnsi->paramCount = 0;
+            memset(pAnsi->aryParam, 0, sizeof(pAnsi->aryParam));
+        } else if (c == '7') {
+            pAnsi->saveLine = pAnsi->line;
+            pAnsi->saveColumn = pAnsi->column;
+        } else if (c == '8') {
+            lcd_AnsiMoveTo(pAnsi, pAnsi->saveLine, pAnsi->saveColumn);
+        } else if (c == 'c') {
+            // 画面と位置に加えて、カーソルの表示と属性も初期の状態に戻す
+            lcd_ModelClear();
+            lcd_AnsiMoveTo(pAnsi, 0, 0);
+            pAnsi->saveLine = 0;
+            pAnsi->saveColumn = 0;
+            pAnsi->isUnderLine = false;
+            pAnsi->isBlink = false;
+            pAnsi->isCursorVisible = true;
+            pAnsi->isCursorDirty = true;
+        }
+        return;
+    case LCD_ANSI_CSI:
+        if (c >= '0' && c <= '9') {
+            if (pAnsi->paramCount == 0) pAnsi->paramCount = 1;
+            if (pAnsi->paramCount <= LCD_ANSI_PARAMS) {
+                uint16_t *pParam = &pAnsi->aryParam[pAnsi->paramCount - 1];
+                *pParam = (*pParam < 1000) ? *pParam * 10 + (c - '0') : *pParam;
+            }
+        } else if (c == ';') {
+            if (pAnsi->paramCount == 0) pAnsi->paramCount = 1;
+            if (pAnsi->paramCount <= LCD_ANSI_PARAMS) pAnsi->paramCount++;
+        } else if (c == '?') {
+            pAnsi->isPrivate = true;
+        } else if (c >= 0x40 && c <= 0x7E) {
+            if (pAnsi->paramCount > LCD_ANSI_PARAMS) pAnsi->paramCount = LCD_ANSI_PARAMS;
+            pAnsi->state = LCD_ANSI_TEXT;
+            lcd_AnsiCsi(pAnsi, c);
+        } else if (c == 0x1B) {
+            pAnsi->state = LCD_ANSI_ESC;        // 途中で新しいシーケンスが始まった
+        }
+        return;
+    default:
+        break;
+    }
+    if (c == 0x1B) {
+        pAnsi->state = LCD_ANSI_ESC;
+    } else if (c == '\r') {
+        pAnsi->column = 0;
+    } else if (c == '\n') {
+        lcd_AnsiMoveTo(pAnsi, pAnsi->line + 1, pAnsi->column);
+    } else if (c == '\b') {
+        lcd_AnsiMoveTo(pAnsi, pAnsi->line, pAnsi->column - 1);
+    } else if ((uint8_t)c >= 0x20) {
+        if (pAnsi->column < MAX_CHARS) {        // 右端を超えた文字は捨てる
+            lcd_ModelWrite(pAnsi->line, pAnsi->column, &c, 1);
+            pAnsi->column++;
+        }
+    }
+}
+/**
+ * @brief エスケープシーケンスを含む文字列を解釈して、液晶に表示する。
+ *
+ * @param pAnsi 状態
+ * @param s 文字列。シーケンスの途中で終わっていてもよい（続きは次の呼び出しで解釈する）。
+ * @param length 文字列の長さ。負の値の場合はNULL文字まで。
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ * @details 文字と消去は表示内容のモデルに書き込み、最後にトランザクションとしてまとめて送信する。
+ * 右端を超えた文字は捨てる（折り返さない）。'\\n'は次の行に、'\\r'は行の先頭に移動する。最後の行から下にはスクロールしない。
+ * 呼び出し元がlcd_begin()のトランザクションの中の場合は、送信はそのトランザクションの終わりで行う。\n
+ * カーソルの表示と属性（ESC[?25h/l、SGR）は、途中では状態に記録するだけで、文字をまとめて送信した後に１回だけ液晶に設定する。
+ * 呼び出し元のトランザクションの中の場合は、文字より先に表示されないように、トランザクションの外で次にこの関数を呼び出したときに設定する。
+ */
+int lcd_AnsiWrite(LCDAnsi *pAnsi, const char *s, int length)
+{
+    if (length < 0) {
+        length = strlen(s);
+    }
+    int depth = lcd_begin();
+    for (int i = 0; i < length; i++) {
+        lcd_AnsiPut(pAnsi, s[i]);
+    }
+    lcd_CursorPosition(pAnsi->line, (pAnsi->column < MAX_CHARS) ? pAnsi->column : MAX_CHARS - 1);
+    int iRet = (depth > 0) ? lcd_commit() : lcd_Flush();
+    if (iRet < 0 || !pAnsi->isCursorDirty || depth > 1) return iRet;
+    uint32_t startBytes = lcdSetting.busStats.bytes;
+    lcd_AnsiApplyCursor(pAnsi);
+    pAnsi->isCursorDirty = false;
+    return iRet + (int)(lcdSetting.busStats.bytes - startBytes);
+}
+/**
+ * @brief エスケープシーケンスを含む文字列(NULL終了)を解釈して、液晶に表示する。
+ *
+ * @param pAnsi 状態
+ * @param s 文字列
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ */
+int lcd_AnsiWrite(LCDAnsi *pAnsi, const char *s)
+{
+    return lcd_AnsiWrite(pAnsi, s, -1);
+}
@@ -0,0 +1,57 @@
+/**
+ * @file i2cLCDAnsi.h
+ * @author Hisayuki Nomura
+ * @brief ANSI/VT100のエスケープシーケンスの一部を解釈して、液晶に表示するためのヘッダファイル。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details エスケープシーケンスを使用するプログラムは、i2cLCD.hに続けてこのヘッダファイルをincludeする。
+ */
+#ifndef __i2cLCDAnsi_h__
+#define __i2cLCDAnsi_h__
+
+#include "i2cLCD.h"
+
+/// @brief エスケープシーケンスの数値パラメータの最大の数。これより多いパラメータは無視する。
+#define LCD_ANSI_PARAMS     2
+
+/**
+ * @brief エスケープシーケンスの解釈の状態。アプリケーションが確保し、lcd_AnsiInit()で初期化する。
+ * @details 文字を１つずつ受け取って状態を進めるので、シーケンスの途中で入力が分かれていても、続きから解釈できる。
+ * 使用するメモリは、入力の長さにかかわらずこの構造体だけ。
+ */
+struct LCDAnsi {
+    /// @brief 解釈の状態（０：通常の文字、１：ESCの次、２：CSIのパラメータ）
+    uint8_t state;
+    /// @brief CSIで'?'が付いている場合はtrue
+    bool isPrivate;
+    /// @brief 受け取ったパラメータの数
+    uint8_t paramCount;
+    /// @brief パラメータ
+    uint16_t aryParam[LCD_ANSI_PARAMS];
+    /// @brief カーソルの行
+    uint8_t line;
+    /// @brief カーソルのカラム
+    uint8_t column;
+    /// @brief 保存したカーソルの行
+    uint8_t saveLine;
+    /// @brief 保存したカーソルのカラム
+    uint8_t saveColumn;
+    /// @brief カーソルを表示している場合はtrue
+    bool isCursorVisible;
+    /// @brief 下線の属性（SGR 4）
+    bool isUnderLine;
+    /// @brief 点滅の属性（SGR 5）
+    bool isBlink;
+    /// @brief カーソルの表示や属性を変えて、まだ液晶に設定していない場合はtrue。lcd_AnsiWrite()の送信の後に設定する。
+    bool isCursorDirty;
+};
+
+int lcd_AnsiInit(LCDAnsi *pAnsi);
+int lcd_AnsiWrite(LCDAnsi *pAnsi, const char *s, int length);
+int lcd_AnsiWrite(LCDAnsi *pAnsi, const char *s);
+
+#endif
@@ -0,0 +1,234 @@
+/**
+ * @file i2cLCDBigDigit.cpp
+ * @author Hisayuki Nomura
+ * @brief ２行分の高さの大きな数字を、外字の部品を組み合わせて表示するための処理。\n
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details 5x8ドットの文字は、離れた場所からは読みにくい。ここでは、角や横棒などの８つの部品を外字に登録し、
+ * 幅３カラム、高さ２行で１つの数字を表す。部品はlcd_BigDigitInit()で、１回のトランザクションでまとめて登録する。\n
+ * 数字は表示内容のモデルに書き込むので、値が変わっても、液晶に送信されるのは形が変わった数字のセルだけになる。
+ * 幅はカラム数で指定するので、8カラム（AQM0802）では数字２つ、16カラム（SB1602B）では数字４つと小数点などが入る。
+ *
+ * @code
+ *  lcd_BigDigitInit();
+ *  while (true) {
+ *      lcd_BigDigitPrintf(0, MAX_CHARS, "%d.%d", temp / 10, temp % 10);
+ *      lcd_flush_step(500);
+ *  }
+ * @endcode
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "i2cLCD.h"
+#include "i2cLCDlocal.h"
+#include "i2cLCDBigDigit.h"
+
+/// @brief 部品の文字コード：左上の角
+#define BD_LT   0
+/// @brief 部品の文字コード：上の横棒
+#define BD_UB   1
+/// @brief 部品の文字コード：右上の角
+#define BD_RT   2
+/// @brief 部品の文字コード：左下の角
+#define BD_LL   3
+/// @brief 部品の文字コード：下の横棒
+#define BD_LB   4
+/// @brief 部品の文字コード：右下の角
+#define BD_LR   5
+/// @brief 部品の文字コード：上の横棒と中央の横棒
+#define BD_UMB  6
+/// @brief 部品の文字コード：中央の横棒と下の横棒
+#define BD_LMB  7
+/// @brief 全体を塗りつぶした文字
+#define BD_FF   LCD_BIGDIGIT_FULL
+/// @brief 空白
+#define BD_SP   ' '
+
+/// @brief 部品の外字のパターン（文字コード０～７の順）
+static const uint8_t aryBigDigitGlyph[8][8] = {
+    { 0b00111, 0b01111, 0b11111, 0b11111, 0b11111, 0b11111, 0b11111, 0b11111 },    // BD_LT
+    { 0b11111, 0b11111, 0b11111, 0b00000, 0b00000, 0b00000, 0b00000, 0b00000 },    // BD_UB
+    { 0b11100, 0b11110, 0b11111, 0b11111, 0b11111, 0b11111, 0b11111, 0b11111 },    // BD_RT
+    { 0b11111, 0b11111, 0b11111, 0b11111, 0b11111, 0b11111, 0b01111, 0b00111 },    // BD_LL
+    { 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b11111, 0b11111, 0b11111 },    // BD_LB
+    { 0b11111, 0b11111, 0b11111, 0b11111, 0b11111, 0b11111, 0b11110, 0b11100 },    // BD_LR
+    { 0b11111, 0b11111, 0b11111, 0b00000, 0b00000, 0b00000, 0b11111, 0b11111 },    // BD_UMB
+    { 0b11111, 0b00000, 0b00000, 0b00000, 0b00000, 0b11111, 0b11111, 0b11111 },    // BD_LMB
+};
+
+/// @brief 数字（０～９）の形。[数字][行][カラム]
+static const uint8_t aryBigDigitShape[10][2][LCD_BIGDIGIT_WIDTH] = {
+    { { BD_LT,  BD_UB,  BD_RT  }, { BD_LL,  BD_LB,  BD_LR  } },     // 0
+    { { BD_UB,  BD_RT,  BD_SP  }, { BD_LB,  BD_FF,  BD_LB  } },     // 1
+    { { BD_UMB, BD_UMB, BD_RT  }, { BD_LL,  BD_LMB, BD_LMB } },     // 2
+    { { BD_UMB, BD_UMB, BD_RT  }, { BD_LMB, BD_LMB, BD_LR  } },     // 3
+    { { BD_LL,  BD_LB,  BD_FF  }, { BD_SP,  BD_SP,  BD_FF  } },     // 4
+    { { BD_FF,  BD_UMB, BD_UMB }, { BD_LMB, BD_LMB, BD_LR  } },     // 5
+    { { BD_LT,  BD_UMB, BD_UMB }, { BD_LL,  BD_LMB, BD_LR  } },     // 6
+    { { BD_UB,  BD_UB,  BD_RT  }, { BD_SP,  BD_SP,  BD_FF  } },     // 7
+    { { BD_LT,  BD_UMB, BD_RT  }, { BD_LL,  BD_LMB, BD_LR  } },     // 8
+    { { BD_LT,  BD_UMB, BD_RT  }, { BD_SP,  BD_SP,  BD_FF  } },     // 9
+};
+
+/**
+ * @brief 大きな数字の部品を、外字に登録する。
+ *
+ * @return int i2cで送信したバイト数。負の値の場合はエラー。
+ * @details 外字の８文字（64バイト）を、lcd_CGRAMWrite()で１回のトランザクションで送信する。
+ * 起動時と、ほかの機能で外字を書き換えた後に呼び出す。
+ */
+int lcd_BigDigitInit(void)
+{
+    return lcd_CGRAMWrite(0, &aryBigDigitGlyph[0][0], sizeof(aryBigDigitGlyph));
+}
+/**
+ * @brief 大きな文字１つの幅を求める。
+ *
+ * @param c 文字
+ * @return int 幅（カラム数）
+ */
+static int lcd_BigDigitCharWidth(char c)
+{
+    switch (c) {
+    case '.':
+    case ':':
+        return 1;
+    case '-':
+        return 2;
+    default:
+        return LCD_BIGDIGIT_WIDTH;
+    }
+}
+/**
+ * @brief 文字と文字の間に、空白のカラムを入れるかを調べる。小数点とコロンの前後には入れない。
+ *
+ * @param prev 前の文字
+ * @param c 次の文字
+ * @return bool 空白のカラムを入れる場合はtrue
+ */
+static bool lcd_BigDigitIsGap(char prev, char c)
+{
+    return lcd_BigDigitCharWidth(prev) > 1 && lcd_BigDigitCharWidth(c) > 1;
+}
+/**
+ * @brief 文字列を大きな数字で表示したときの幅を求める。
+ *
+ * @param s 文字列。'0'～'9'、'-'、'.'、':'、' 'を使用できる。
+ * @param length 長さ。負の値の場合はNULL文字まで。
+ * @return int 幅（カラム数）
+ */
+int lcd_BigDigitWidth(const char *s, int length)
+{
+    if (length < 0) {
+        length = strlen(s);
+    }
+    int width = 0;
+    for (int i = 0; i < length; i++) {
+        if (i > 0 && lcd_BigDigitIsGap(s[i - 1], s[i])) width++;
+        width += lcd_BigDigitCharWidth(s[i]);
+    }
+    return width;
+}
+/**
+ * @brief 文字列を大きな数字で、表示内容のモデルの１行目と２行目に書き込む。液晶にはまだ送信されない。
+ *
+ * @param column 表示する範囲の先頭のカラム（DDRAMのカラム）
+ * @param width 表示する範囲の幅（カラム数）
+ * @param s 文字列。'0'～'9'、'-'、'.'、':'、' 'を使用できる。それ以外の文字は空白になる。
+ * @param length 長さ。負の値の場合はNULL文字まで。
+ * @return int 書き込んだセルの数。範囲外の場合は-1。
+ * @details 範囲の中で右寄せにし、残りは空白で埋める。\n
+ * 範囲に入らない場合は、数字の一部だけを表示すると別の値に見えるので、数値のウィジェットの'*'と同じように、
+ * 範囲に入るだけの'-'を表示する。\n
+ * 範囲全体をモデルに書き込むが、液晶に送信されるのは、前の表示と形が変わったセルだけになる。
+ */
+int lcd_BigDigitWrite(int column, int width, const char *s, int length)
+{
+    if (column < 0 || column >= DDRAM_CHARS || width <= 0) return -1;
+    if (width > DDRAM_CHARS - column) {
+        width = DDRAM_CHARS - column;
+    }
+    if (length < 0) {
+        length = strlen(s);
+    }
+    int total = lcd_BigDigitWidth(s, length);
+    char aryOverflow[DDRAM_CHARS];
+    if (total > width) {
+        int count = 0;
+        while (count < DDRAM_CHARS) {
+            aryOverflow[count] = '-';
+            if (lcd_BigDigitWidth(aryOverflow, count + 1) > width) break;
+            count++;
+        }
+        s = aryOverflow;
+        length = count;
+        total = lcd_BigDigitWidth(s, length);
+    }
+    char aryRow[2][DDRAM_CHARS];
+    memset(aryRow, ' ', sizeof(aryRow));
+    int col = (total < width) ? width - total : 0;
+    for (int i = 0; i < length && col < width; i++) {
+        char c = s[i];
+        if (i > 0 && lcd_BigDigitIsGap(s[i - 1], c)) col++;
+        uint8_t aryCell[2][LCD_BIGDIGIT_WIDTH] = { { BD_SP, BD_SP, BD_SP }, { BD_SP, BD_SP, BD_SP } };
+        if (c >= '0' && c <= '9') {
+            memcpy(aryCell, aryBigDigitShape[c - '0'], sizeof(aryCell));
+        } else if (c == '-') {
+            aryCell[0][0] = BD_LB;
+            aryCell[0][1] = BD_LB;
+        } else if (c == '.') {
+            aryCell[1][0] = '.';
+        } else if (c == ':') {
+            aryCell[0][0] = 0xA5;               // CGROMの「･」
+            aryCell[1][0] = 0xA5;
+        }
+        int charWidth = lcd_BigDigitCharWidth(c);
+        for (int x = 0; x < charWidth && col + x < width; x++) {
+            aryRow[0][col + x] = aryCell[0][x];
+            aryRow[1][col + x] = aryCell[1][x];
+        }
+        col += charWidth;
+    }
+    lcd_ModelWrite(0, column, aryRow[0], width);
+    lcd_ModelWrite(1, column, aryRow[1], width);
+    return width * 2;
+}
+/**
+ * @brief 文字列（NULL文字まで）を大きな数字で、表示内容のモデルに書き込む。
+ *
+ * @param column 表示する範囲の先頭のカラム（DDRAMのカラム）
+ * @param width 表示する範囲の幅（カラム数）
+ * @param s 文字列
+ * @return int 書き込んだセルの数。範囲外の場合は-1。
+ */
+int lcd_BigDigitWrite(int column, int width, const char *s)
+{
+    return lcd_BigDigitWrite(column, width, s, -1);
+}
+/**
+ * @brief 書式付きで、大きな数字を表示内容のモデルに書き込む。
+ *
+ * @param column 表示する範囲の先頭のカラム（DDRAMのカラム）
+ * @param width 表示する範囲の幅（カラム数）
+ * @param format 書式（printfと同じ）
+ * @param ... 書式に対応する値
+ * @return int 書き込んだセルの数。範囲外の場合は-1。
+ */
+int lcd_BigDigitPrintf(int column, int width, const char *format, ...)
+{
+    char aryBuf[DDRAM_CHARS + 1];
+    va_list va;
+    va_start(va, format);
+    vsnprintf(aryBuf, sizeof(aryBuf), format, va);
+    va_end(va);
+    return lcd_BigDigitWrite(column, width, aryBuf, -1);
+}
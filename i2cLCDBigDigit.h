@@ -0,0 +1,35 @@
+/**
+ * @file i2cLCDBigDigit.h
+ * @author Hisayuki Nomura
+ * @brief ２行分の高さの大きな数字を表示するためのヘッダファイル。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details 大きな数字を使用するプログラムは、i2cLCD.hに続けてこのヘッダファイルをincludeする。\n
+ * 外字（CGRAM）の８文字をすべて使用するので、ほかの外字とは同時に使えない。
+ * @code
+ *  lcd_BigDigitInit();
+ *  lcd_BigDigitPrintf(0, MAX_CHARS, "%d", rpm);
+ *  lcd_flush_step(500);
+ * @endcode
+ */
+#ifndef __i2cLCDBigDigit_h__
+#define __i2cLCDBigDigit_h__
+
+#include "i2cLCD.h"
+
+/// @brief 数字１文字の幅（カラム数）。数字の間には、さらに１カラムの空白が入る。
+#define LCD_BIGDIGIT_WIDTH  3
+/// @brief 全体を塗りつぶした文字。ST7032のCGROMの0xFF。
+#define LCD_BIGDIGIT_FULL   0xFF
+
+int lcd_BigDigitInit(void);
+int lcd_BigDigitWidth(const char *s, int length);
+int lcd_BigDigitWrite(int column, int width, const char *s, int length);
+int lcd_BigDigitWrite(int column, int width, const char *s);
+int lcd_BigDigitPrintf(int column, int width, const char *format, ...);
+
+#endif
@@ -0,0 +1,218 @@
+/**
+ * @file i2cLCDCanvas.cpp
+ * @author Hisayuki Nomura
+ * @brief 液晶の画面より大きな仮想キャンバスを、表示のシフトを使ってスクロールするための処理。\n
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details 長いログの行や幅の広い表を16x2の液晶でスクロールさせる場合、lcd_stringで書き直すと、１文字スクロールするたびに画面全体を送信することになる。\n
+ * ST7032のDDRAMは１行40文字あり、表示のシフト命令（１命令２バイト）で、どこから表示するかを変えられる。
+ * キャンバスは、表示している16文字の左右にLCD_CANVAS_MARGIN文字ずつを先読みしてDDRAMに置いておき、
+ * 先読みしてある範囲の中のスクロールは表示のシフトだけで行う。新しく先読みの範囲に入ったカラムは、
+ * 表示には関係ないので優先度LCD_PRI_BULKでモデルに書き込み、lcd_flush_step()などのバックグラウンドの送信に任せる。
+ *
+ * @code
+ *  static char aryLog[4][80];
+ *  LCDCanvas canvas;
+ *  lcd_CanvasInit(&canvas, &aryLog[0][0], 80, 4);
+ *  lcd_CanvasWrite(&canvas, 0, 0, "long long log line ...", -1);
+ *  for (int x = 0; x < 64; x++) {
+ *      lcd_CanvasPan(&canvas, x, 0);
+ *      lcd_flush_step(500);                // 先読みの分を送信する
+ *  }
+ * @endcode
+ * キャンバスを使っている間は、画面全体をキャンバスが使用する。ページ切り替えモード（lcd_PageFlipMode）とは同時に使えない。
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "i2cLCD.h"
+#include "i2cLCDlocal.h"
+#include "i2cLCDCanvas.h"
+
+/// @brief 表示している範囲の左右に、先読みしておくカラム数。DDRAMの40文字のうち、表示している文字以外を左右に分ける。
+#define LCD_CANVAS_MARGIN   ((DDRAM_CHARS - MAX_CHARS) / 2)
+
+/**
+ * @brief キャンバスの指定された位置の文字を取り出す。
+ *
+ * @param pCanvas キャンバス
+ * @param x カラム
+ * @param y 行
+ * @return char キャンバスの文字。キャンバスの外の場合は空白。
+ */
+static char lcd_CanvasGet(LCDCanvas *pCanvas, int x, int y)
+{
+    if (x < 0 || x >= pCanvas->width || y < 0 || y >= pCanvas->height) return ' ';
+    return pCanvas->pCells[y * pCanvas->width + x];
+}
+/**
+ * @brief キャンバスのカラムfrom～to-1を、DDRAMの対応する位置（カラム番号をDDRAM_CHARSで割った余り）のモデルに書き込む。
+ *
+ * @param pCanvas キャンバス
+ * @param from 先頭のカラム
+ * @param to 末尾のカラム+1
+ * @param pri 書き込む優先度
+ * @return int 書き込んだカラム数
+ */
+static int lcd_CanvasLoad(LCDCanvas *pCanvas, int from, int to, LCD_PRIORITY pri)
+{
+    for (int x = from; x < to; x++) {
+        for (int line = 0; line < MAX_LINES; line++) {
+            char c = lcd_CanvasGet(pCanvas, x, pCanvas->viewY + line);
+            lcd_ModelWrite(line, x % DDRAM_CHARS, &c, 1, pri);
+        }
+    }
+    return (to > from) ? to - from : 0;
+}
+/**
+ * @brief 表示のシフト量を、キャンバスのカラムxが画面の左端に来るように合わせる。
+ *
+ * @param x 画面の左端に表示するカラム
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ * @details DDRAMは１行ごとに循環しているので、左右のうち近いほうにシフトする。
+ */
+static int lcd_CanvasAlign(int x)
+{
+    int delta = (x % DDRAM_CHARS - lcdSetting.displayShift + DDRAM_CHARS) % DDRAM_CHARS;
+    if (delta == 0) return 0;
+    if (delta <= DDRAM_CHARS / 2) {
+        return lcd_DisplayShift((int8_t)-delta);    // 左にシフトすると、右側のカラムが現れる
+    }
+    return lcd_DisplayShift((int8_t)(DDRAM_CHARS - delta));
+}
+
+/**
+ * @brief キャンバスを初期化し、左上から表示する。
+ *
+ * @param pCanvas 初期化するキャンバス
+ * @param pCells キャンバスの内容を入れるバッファ。width×heightバイト以上必要。空白で埋められる。
+ * @param width キャンバスの幅
+ * @param height キャンバスの高さ
+ * @return int 送信したバイト数。負の値の場合はエラー。引数が正しくない場合は-1。
+ */
+int lcd_CanvasInit(LCDCanvas *pCanvas, char *pCells, int width, int height)
+{
+    if (pCells == NULL || width <= 0 || height <= 0) return -1;
+    memset(pCells, ' ', width * height);
+    pCanvas->pCells = pCells;
+    pCanvas->width = width;
+    pCanvas->height = height;
+    pCanvas->viewX = 0;
+    pCanvas->viewY = 0;
+    pCanvas->winStart = 0;
+    memset(&pCanvas->stats, 0, sizeof(pCanvas->stats));
+    lcd_CanvasLoad(pCanvas, 0, DDRAM_CHARS, LCD_PRI_NORMAL);
+    int iSendBytes = 0;
+    int iRet = lcd_FlushPriority(LCD_PRI_NORMAL);
+    if (iRet < 0) return iRet;
+    iSendBytes += iRet;
+    iRet = lcd_CanvasAlign(0);
+    if (iRet < 0) return iRet;
+    iSendBytes += iRet;
+    return iSendBytes;
+}
+/**
+ * @brief キャンバスに文字列を書き込む。
+ *
+ * @param pCanvas キャンバス
+ * @param x 先頭のカラム
+ * @param y 行
+ * @param s 書き込む文字列
+ * @param length 書き込む長さ。負の値の場合は文字列の長さ（NULL文字まで）。
+ * @return int 書き込んだ文字数。キャンバスの幅を超えた部分は捨てられる。範囲外の場合は-1。
+ * @details DDRAMに読み込んである範囲の文字は、モデルにも書き込む（液晶への送信はlcd_Flush()などで行う）。
+ * 画面に表示している部分はLCD_PRI_NORMAL、先読みの部分はLCD_PRI_BULKの優先度になる。
+ */
+int lcd_CanvasWrite(LCDCanvas *pCanvas, int x, int y, const char *s, int length)
+{
+    if (x < 0 || x >= pCanvas->width || y < 0 || y >= pCanvas->height) return -1;
+    if (length < 0) {
+        length = strlen(s);
+    }
+    if (length > pCanvas->width - x) {
+        length = pCanvas->width - x;
+    }
+    memcpy(&pCanvas->pCells[y * pCanvas->width + x], s, length);
+    int line = y - pCanvas->viewY;
+    if (line < 0 || line >= MAX_LINES) return length;      // DDRAMに読み込んでいない行
+    for (int i = 0; i < length; i++) {
+        int cx = x + i;
+        if (cx < pCanvas->winStart || cx >= pCanvas->winStart + DDRAM_CHARS) continue;
+        bool isVisible = (cx >= pCanvas->viewX && cx < pCanvas->viewX + MAX_CHARS);
+        lcd_ModelWrite(line, cx % DDRAM_CHARS, &s[i], 1, isVisible ? LCD_PRI_NORMAL : LCD_PRI_BULK);
+    }
+    return length;
+}
+/**
+ * @brief キャンバスの表示位置を変える（スクロールする）。
+ *
+ * @param pCanvas キャンバス
+ * @param x 画面の左端に表示するカラム。キャンバスの外にはみ出す場合は、はみ出さない位置にする。
+ * @param y 画面の１行目に表示する行。
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ * @details 新しい表示位置が、DDRAMに読み込んである40文字の範囲に収まる場合は、まだ送信していない画面内の文字だけを送信してから、
+ * 表示のシフト命令で表示位置を動かす。読み込む範囲は表示位置に合わせて動かし、新しく範囲に入ったカラムは先読みとして
+ * LCD_PRI_BULKでモデルに書き込む（この関数では送信しない）。\n
+ * 範囲に収まらない場合や、行が変わる場合は、読み込む範囲全体を書き直す。この場合も、画面に表示する部分だけを先に送信する。
+ */
+int lcd_CanvasPan(LCDCanvas *pCanvas, int x, int y)
+{
+    int maxX = pCanvas->width - MAX_CHARS;
+    int maxY = pCanvas->height - MAX_LINES;
+    if (x > maxX) x = maxX;
+    if (x < 0) x = 0;
+    if (y > maxY) y = maxY;
+    if (y < 0) y = 0;
+    uint32_t startBytes = lcdSetting.busStats.bytes;
+    int newStart = x - LCD_CANVAS_MARGIN;
+    if (newStart < 0) newStart = 0;
+    bool isInWindow = (x >= pCanvas->winStart && x + MAX_CHARS <= pCanvas->winStart + DDRAM_CHARS);
+    if (y != pCanvas->viewY || !isInWindow) {
+        // 行が変わるか、読み込んである範囲から外れる場合は、範囲全体を読み直す
+        pCanvas->viewY = y;
+        pCanvas->winStart = newStart;
+        pCanvas->stats.prefetchCells += lcd_CanvasLoad(pCanvas, newStart, newStart + DDRAM_CHARS, LCD_PRI_BULK) * MAX_LINES;
+    } else if (newStart > pCanvas->winStart) {
+        int from = pCanvas->winStart + DDRAM_CHARS;
+        if (from < newStart) from = newStart;
+        pCanvas->stats.prefetchCells += lcd_CanvasLoad(pCanvas, from, newStart + DDRAM_CHARS, LCD_PRI_BULK) * MAX_LINES;
+        pCanvas->winStart = newStart;
+    } else if (newStart < pCanvas->winStart) {
+        int to = pCanvas->winStart;
+        if (to > newStart + DDRAM_CHARS) to = newStart + DDRAM_CHARS;
+        pCanvas->stats.prefetchCells += lcd_CanvasLoad(pCanvas, newStart, to, LCD_PRI_BULK) * MAX_LINES;
+        pCanvas->winStart = newStart;
+    }
+    // 画面に現れる部分は、シフトの前に送信しておく。先読み済みで送信が終わっていれば、何も送信されない
+    lcd_CanvasLoad(pCanvas, x, x + MAX_CHARS, LCD_PRI_NORMAL);
+    int iRet = lcd_FlushPriority(LCD_PRI_NORMAL);
+    if (iRet < 0) return iRet;
+    bool isShiftOnly = (iRet == 0);
+    iRet = lcd_CanvasAlign(x);
+    if (iRet < 0) return iRet;
+    pCanvas->viewX = x;
+    uint32_t stepBytes = lcdSetting.busStats.bytes - startBytes;
+    pCanvas->stats.steps++;
+    if (isShiftOnly) pCanvas->stats.shiftSteps++;
+    pCanvas->stats.bytes += stepBytes;
+    pCanvas->stats.lastStepBytes = stepBytes;
+    pCanvas->stats.redrawBytes += MAX_LINES * (3 + MAX_CHARS);     // 行ごとに[アドレス設定]＋[データ16文字]
+    return (int)stepBytes;
+}
+/**
+ * @brief キャンバスのスクロールの統計を取得する。
+ *
+ * @param pCanvas キャンバス
+ * @param pStats 統計を受け取る構造体
+ */
+void lcd_CanvasStatsGet(LCDCanvas *pCanvas, LCDCanvasStats *pStats)
+{
+    *pStats = pCanvas->stats;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file i2cLCDCanvas.h
+ * @author Hisayuki Nomura
+ * @brief 液晶の画面より大きな仮想キャンバスと、表示のシフトを使ったスクロールのヘッダファイル。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details キャンバスを使用するプログラムは、i2cLCD.hに続けてこのヘッダファイルをincludeする。
+ */
+#ifndef __i2cLCDCanvas_h__
+#define __i2cLCDCanvas_h__
+
+#include "i2cLCD.h"
+
+/**
+ * @brief キャンバスのスクロールの統計。全体を書き直した場合と比べるために使用する。
+ */
+struct LCDCanvasStats {
+    /// @brief スクロール（lcd_CanvasPan）の回数
+    uint32_t steps;
+    /// @brief 表示のシフトだけで済んだスクロールの回数
+    uint32_t shiftSteps;
+    /// @brief スクロールの中で送信したバイト数の合計
+    uint32_t bytes;
+    /// @brief 最後のスクロールで送信したバイト数
+    uint32_t lastStepBytes;
+    /// @brief 同じスクロールを、画面全体を書き直して行った場合のバイト数の合計
+    uint32_t redrawBytes;
+    /// @brief 先読みとして、lcd_flush_step()などのバックグラウンドの送信に回したセルの数
+    uint32_t prefetchCells;
+};
+
+/**
+ * @brief 液晶の画面より大きな仮想キャンバス。
+ * @details 内容はアプリケーションが用意したwidth×heightバイトのバッファに持つ。DDRAMの各行の40文字には、キャンバスのカラム
+ * winStart～winStart+39を、カラム番号をDDRAM_CHARSで割った余りの位置に読み込んでおく。表示しているのはそのうちviewXからの16文字で、
+ * 左右にスクロールするときは、表示のシフト命令だけで表示位置を動かし、新しく読み込む範囲に入ったカラムだけを送信する。
+ */
+struct LCDCanvas {
+    /// @brief キャンバスの内容。width×heightバイトで、行ごとに並んでいる
+    char *pCells;
+    /// @brief キャンバスの幅
+    int width;
+    /// @brief キャンバスの高さ
+    int height;
+    /// @brief 画面の左端に表示しているキャンバスのカラム
+    int viewX;
+    /// @brief 画面の１行目に表示しているキャンバスの行
+    int viewY;
+    /// @brief DDRAMに読み込んである範囲の先頭のカラム
+    int winStart;
+    /// @brief スクロールの統計
+    LCDCanvasStats stats;
+};
+
+int lcd_CanvasInit(LCDCanvas *pCanvas, char *pCells, int width, int height);
+int lcd_CanvasWrite(LCDCanvas *pCanvas, int x, int y, const char *s, int length);
+int lcd_CanvasPan(LCDCanvas *pCanvas, int x, int y);
+void lcd_CanvasStatsGet(LCDCanvas *pCanvas, LCDCanvasStats *pStats);
+
+#endif
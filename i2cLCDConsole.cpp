@@ -0,0 +1,197 @@
+/**
+ * @file i2cLCDConsole.cpp
+ * @author Hisayuki Nomura
+ * @brief 液晶をログ出力用のコンソールとして使うための処理。\n
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details lcd_stringは改行を解釈せず、画面の右端を超えた文字は見えないDDRAMに書き込まれてしまう。\n
+ * コンソールは、'\\n'、'\\r'、'\\b'と右端での折り返しを処理し、最後の行を超えると表示している行を上にスクロールする。
+ * 出力した行はLCD_CONSOLE_HISTORY行までリングバッファに保存され、lcd_ConsoleView()で過去の行を遡って表示できる。\n
+ * 出力はリングバッファと表示内容のモデルに書き込むだけで、I2Cの送信は行わない。スクロールしても、モデルの差分として
+ * 実際に文字が変わったセルだけが、lcd_flush_step()などで送信される。
+ *
+ * @code
+ *  static LCDConsole con;
+ *  lcd_ConsoleInit(&con, 0, MAX_LINES);
+ *  lcd_ConsolePrintf(&con, "boot %d\n", count);
+ *  lcd_flush_step(500);
+ * @endcode
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "i2cLCD.h"
+#include "i2cLCDlocal.h"
+#include "i2cLCDConsole.h"
+
+/**
+ * @brief 古い方から数えた行の番号から、リングバッファの行を求める。
+ *
+ * @param pCon コンソール
+ * @param index 一番古い行を０とした行の番号（０～count-1）
+ * @return char* リングバッファの行
+ */
+static char *lcd_ConsoleRow(LCDConsole *pCon, int index)
+{
+    int slot = (pCon->head - (pCon->count - 1 - index) + LCD_CONSOLE_HISTORY) % LCD_CONSOLE_HISTORY;
+    return pCon->aryRing[slot];
+}
+/**
+ * @brief 表示する行を、表示内容のモデルに書き込む。
+ *
+ * @param pCon コンソール
+ * @details 内容が変わっていないセルは、モデルの中で送信済みのままになるので送信されない。
+ */
+static void lcd_ConsoleRender(LCDConsole *pCon)
+{
+    int top = pCon->count - pCon->height - pCon->viewOffset;
+    if (top < 0) top = 0;
+    for (int r = 0; r < pCon->height; r++) {
+        if (top + r < pCon->count) {
+            lcd_ModelWrite(pCon->line + r, 0, lcd_ConsoleRow(pCon, top + r), MAX_CHARS, pCon->pri);
+        } else {
+            lcd_ModelFill(pCon->line + r, 0, ' ', MAX_CHARS, pCon->pri);
+        }
+    }
+}
+/**
+ * @brief コンソールを初期化する。
+ *
+ * @param pCon 初期化するコンソール
+ * @param line コンソールに使う最初の行
+ * @param height コンソールに使う行数
+ * @return int ０。画面からはみ出す場合は-1。
+ * @details コンソールの行は空白になる（モデルに書き込むだけで、送信はlcd_Flush()などで行う）。
+ */
+int lcd_ConsoleInit(LCDConsole *pCon, int line, int height)
+{
+    if (line < 0 || height <= 0 || line + height > MAX_LINES) return -1;
+    pCon->line = line;
+    pCon->height = height;
+    pCon->pri = LCD_PRI_NORMAL;
+    return lcd_ConsoleClear(pCon);
+}
+/**
+ * @brief コンソールの内容と、保存していた過去の行をすべて消す。
+ *
+ * @param pCon コンソール
+ * @return int 常に０
+ */
+int lcd_ConsoleClear(LCDConsole *pCon)
+{
+    memset(pCon->aryRing, ' ', sizeof(pCon->aryRing));
+    pCon->head = 0;
+    pCon->count = 1;
+    pCon->curColumn = 0;
+    pCon->viewOffset = 0;
+    lcd_ConsoleRender(pCon);
+    return 0;
+}
+/**
+ * @brief 新しい行を追加する。リングバッファがいっぱいの場合は、一番古い行を捨てる。
+ *
+ * @param pCon コンソール
+ */
+static void lcd_ConsoleNewLine(LCDConsole *pCon)
+{
+    pCon->head = (pCon->head + 1) % LCD_CONSOLE_HISTORY;
+    memset(pCon->aryRing[pCon->head], ' ', MAX_CHARS);
+    if (pCon->count < LCD_CONSOLE_HISTORY) {
+        pCon->count++;
+    }
+    pCon->curColumn = 0;
+    // 過去の行を表示している場合は、同じ行を表示し続ける
+    if (pCon->viewOffset > 0 && pCon->viewOffset < pCon->count - pCon->height) {
+        pCon->viewOffset++;
+    }
+}
+/**
+ * @brief コンソールに文字列を出力する。
+ *
+ * @param pCon コンソール
+ * @param s 出力する文字列。'\\n'で次の行に、'\\r'で行の先頭に移動し、'\\b'で１文字戻る（文字は消さない）。
+ * @param length 出力する長さ。負の値の場合は文字列の長さ（NULL文字まで）。
+ * @return int 出力した文字数（制御文字は含まない）
+ * @details 右端を超えると次の行に折り返す。I2Cの送信は行わず、表示内容のモデルに書き込むだけなので、すぐに戻る。
+ */
+int lcd_ConsoleWrite(LCDConsole *pCon, const char *s, int length)
+{
+    int count = 0;
+    if (length < 0) {
+        length = strlen(s);
+    }
+    for (int i = 0; i < length; i++) {
+        char c = s[i];
+        if (c == '\n') {
+            lcd_ConsoleNewLine(pCon);
+        } else if (c == '\r') {
+            pCon->curColumn = 0;
+        } else if (c == '\b') {
+            if (pCon->curColumn > 0) pCon->curColumn--;
+        } else {
+            if (pCon->curColumn >= MAX_CHARS) {
+                lcd_ConsoleNewLine(pCon);
+            }
+            pCon->aryRing[pCon->head][pCon->curColumn++] = c;
+            count++;
+        }
+    }
+    lcd_ConsoleRender(pCon);
+    return count;
+}
+/**
+ * @brief コンソールに文字列(NULL終了)を出力する。
+ *
+ * @param pCon コンソール
+ * @param s 出力する文字列
+ * @return int 出力した文字数
+ */
+int lcd_ConsoleWrite(LCDConsole *pCon, const char *s)
+{
+    return lcd_ConsoleWrite(pCon, s, -1);
+}
+/**
+ * @brief コンソールに、フォーマットされた文字列を出力する。
+ *
+ * @param pCon コンソール
+ * @param format C標準のprintfフォーマット
+ * @param ...
+ * @return int 出力した文字数
+ * @details フォーマットした結果は、LCD_CONSOLE_HISTORY行分の文字数までで切り捨てられる。\n
+ * フォーマットに使うバッファはスタックではなく静的に確保しているので、割り込みの中や複数のコアから同時に呼び出さないこと。
+ */
+int lcd_ConsolePrintf(LCDConsole *pCon, const char *format, ...)
+{
+    static char aryConsoleBuf[LCD_CONSOLE_HISTORY * MAX_CHARS + 1];
+    va_list va;
+    va_start(va, format);
+    vsnprintf(aryConsoleBuf, sizeof(aryConsoleBuf), format, va);
+    va_end(va);
+    return lcd_ConsoleWrite(pCon, aryConsoleBuf, -1);
+}
+/**
+ * @brief 保存している過去の行を遡って表示する。
+ *
+ * @param pCon コンソール
+ * @param offset 最新の行から何行遡って表示するか。０の場合は最新の行を表示する。
+ * @return int 実際に遡った行数。保存している行数を超える場合は、一番古い行までになる。
+ * @details 遡って表示している間に新しい行が出力されても、表示している行は変わらない。０を指定すると最新の行の表示に戻る。
+ */
+int lcd_ConsoleView(LCDConsole *pCon, int offset)
+{
+    int maxOffset = pCon->count - pCon->height;
+    if (maxOffset < 0) maxOffset = 0;
+    if (offset > maxOffset) offset = maxOffset;
+    if (offset < 0) offset = 0;
+    pCon->viewOffset = offset;
+    lcd_ConsoleRender(pCon);
+    return offset;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file i2cLCDConsole.h
+ * @author Hisayuki Nomura
+ * @brief 液晶をログ出力用のコンソールとして使うためのヘッダファイル。改行、スクロールと、過去の行の保存（スクロールバック）を行う。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details コンソールを使用するプログラムは、i2cLCD.hに続けてこのヘッダファイルをincludeする。
+ */
+#ifndef __i2cLCDConsole_h__
+#define __i2cLCDConsole_h__
+
+#include "i2cLCD.h"
+
+/// @brief コンソールが保存しておく行数（表示中の行を含む）。スクロールバックで遡れるのは、この行数から表示行数を引いた分まで。
+#define LCD_CONSOLE_HISTORY     32
+
+/**
+ * @brief コンソール。アプリケーションが静的に確保し、lcd_ConsoleInit()で初期化する。
+ * @details 出力された文字は、まず行のリングバッファに書き込まれ、表示している行だけが表示内容のモデルに書き込まれる。
+ * 液晶への送信はlcd_flush_step()やlcd_FlushAsync()で行うので、大量のログを出力しても、出力する側がI2Cの送信を待つことはない。
+ */
+struct LCDConsole {
+    /// @brief コンソールに使う最初の行
+    uint8_t line;
+    /// @brief コンソールに使う行数
+    uint8_t height;
+    /// @brief 最新の行の中のカーソルのカラム
+    uint8_t curColumn;
+    /// @brief モデルに書き込むときの優先度
+    LCD_PRIORITY pri;
+    /// @brief 最新の行が入っているaryRingの添え字
+    uint16_t head;
+    /// @brief aryRingに入っている行数（１～LCD_CONSOLE_HISTORY）
+    uint16_t count;
+    /// @brief 最新の行から何行遡って表示しているか。０の場合は最新の行を表示する。
+    uint16_t viewOffset;
+    /// @brief 行のリングバッファ
+    char aryRing[LCD_CONSOLE_HISTORY][MAX_CHARS];
+};
+
+int lcd_ConsoleInit(LCDConsole *pCon, int line, int height);
+int lcd_ConsoleClear(LCDConsole *pCon);
+int lcd_ConsoleWrite(LCDConsole *pCon, const char *s, int length);
+int lcd_ConsoleWrite(LCDConsole *pCon, const char *s);
+int lcd_ConsolePrintf(LCDConsole *pCon, const char *format, ...);
+int lcd_ConsoleView(LCDConsole *pCon, int offset);
+
+#endif
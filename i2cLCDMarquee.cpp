@@ -0,0 +1,139 @@
+/**
+ * @file i2cLCDMarquee.cpp
+ * @author Hisayuki Nomura
+ * @brief 表示のシフト命令だけで、１行の長い文字列を流し続けるマーキーの処理。\n
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details 画面より長い文字列を流すときに、lcd_stringで行を書き直すと、１文字流すたびに16文字分を送信することになる。
+ * マーキーは、DDRAMの１行40文字に文字列を一度だけ読み込んでおき、後は表示のシフト命令（１命令２バイト）だけで流す。\n
+ * 文字列が40文字以下の場合は、残りを空白で埋めた40文字がそのまま一周になるので、最初に読み込んだ後はシフト命令しか送信しない。
+ * 40文字より長い場合は、流すたびに画面の左から外に出たカラムへ、40文字先の文字を優先度LCD_PRI_BULKでモデルに書き戻す。
+ * 書き戻したカラムが画面に現れるのは24文字流した後なので、その間にlcd_flush_step()などのバックグラウンドの送信で送られていれば、
+ * 流す処理そのものはシフト命令の２バイトだけで済む。間に合わなかった場合だけ、画面に現れる１文字を先に送信する。
+ *
+ * @code
+ *  static LCDMarquee marquee;
+ *  lcd_MarqueeInit(&marquee, 0, "This is a very long message that does not fit in the DDRAM line.", 300);
+ *  while (true) {
+ *      lcd_MarqueeTick(&marquee);
+ *      lcd_flush_step(500);                // 書き戻した文字を送信する
+ *  }
+ * @endcode
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "i2cLCD.h"
+#include "i2cLCDlocal.h"
+#include "i2cLCDMarquee.h"
+
+/**
+ * @brief 一周の中の位置の文字を取り出す。
+ *
+ * @param pMarquee マーキー
+ * @param position 一周の中の位置。一周の長さを超える場合は、次の周回として扱う。
+ * @return char 文字。文字列の後ろの部分は空白。
+ */
+static char lcd_MarqueeChar(LCDMarquee *pMarquee, int position)
+{
+    position %= pMarquee->period;
+    return (position < pMarquee->length) ? pMarquee->pText[position] : ' ';
+}
+/**
+ * @brief マーキーを初期化し、文字列の先頭から40文字を液晶に送信する。
+ *
+ * @param pMarquee マーキー
+ * @param line 流す行
+ * @param text 流す文字列。コピーしないので、流している間は残しておく必要がある。
+ * @param intervalMs lcd_MarqueeTick()で１文字流す間隔（ミリ秒）
+ * @return int 送信したバイト数。負の値の場合はエラー。引数が正しくない場合は-1。
+ * @details 表示のシフトは今の位置のまま変えず、画面の左端に文字列の先頭が来るように、行の40文字全体を書き込んで送信する。
+ */
+int lcd_MarqueeInit(LCDMarquee *pMarquee, int line, const char *text, uint32_t intervalMs)
+{
+    if (line < 0 || line >= MAX_LINES || text == NULL) return -1;
+    memset(pMarquee, 0, sizeof(LCDMarquee));
+    pMarquee->pText = text;
+    pMarquee->length = strlen(text);
+    pMarquee->period = (pMarquee->length <= DDRAM_CHARS) ? DDRAM_CHARS : pMarquee->length + LCD_MARQUEE_GAP;
+    pMarquee->line = line;
+    pMarquee->left = lcdSetting.displayShift;
+    pMarquee->head = 0;
+    pMarquee->intervalUs = intervalMs * 1000;
+    pMarquee->nextStepUs = time_us_64() + pMarquee->intervalUs;
+    for (int i = 0; i < DDRAM_CHARS; i++) {
+        char c = lcd_MarqueeChar(pMarquee, i);
+        lcd_ModelWrite(line, (pMarquee->left + i) % DDRAM_CHARS, &c, 1, LCD_PRI_NORMAL);
+    }
+    return lcd_FlushPriority(LCD_PRI_NORMAL);
+}
+/**
+ * @brief 文字列を１文字左に流す。
+ *
+ * @param pMarquee マーキー
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ * @details 画面の右端に現れる文字が送信済みであれば、送信するのは表示のシフト命令１つ（２バイト）だけ。
+ * 送信されていない場合は、その文字を優先度LCD_PRI_NORMALに上げて、シフトの前に送信する。\n
+ * シフトの後、画面の左から外に出たカラムに、40文字先の文字をLCD_PRI_BULKでモデルに書き戻す（この関数では送信しない）。
+ */
+int lcd_MarqueeStep(LCDMarquee *pMarquee)
+{
+    uint32_t startBytes = lcdSetting.busStats.bytes;
+    // シフトの後に画面の右端に現れるカラムは、先に送信しておく。送信済みであれば何も送信されない
+    char c = lcd_MarqueeChar(pMarquee, pMarquee->head + MAX_CHARS);
+    lcd_ModelWrite(pMarquee->line, (pMarquee->left + MAX_CHARS) % DDRAM_CHARS, &c, 1, LCD_PRI_NORMAL);
+    int iRet = lcd_FlushPriority(LCD_PRI_NORMAL);
+    if (iRet < 0) return iRet;
+    bool isShiftOnly = (iRet == 0);
+    iRet = lcd_DisplayShift(-1);
+    if (iRet < 0) return iRet;
+    int leaving = pMarquee->left;
+    pMarquee->left = (pMarquee->left + 1) % DDRAM_CHARS;
+    pMarquee->head = (pMarquee->head + 1) % pMarquee->period;
+    if (pMarquee->period != DDRAM_CHARS) {
+        // 一周が40文字の場合は、外に出たカラムの文字がそのまま40文字先の文字なので、書き戻す必要はない
+        c = lcd_MarqueeChar(pMarquee, pMarquee->head + DDRAM_CHARS - 1);
+        lcd_ModelWrite(pMarquee->line, leaving, &c, 1, LCD_PRI_BULK);
+        pMarquee->stats.refillCells++;
+    }
+    uint32_t stepBytes = lcdSetting.busStats.bytes - startBytes;
+    pMarquee->stats.steps++;
+    if (isShiftOnly) pMarquee->stats.shiftSteps++;
+    pMarquee->stats.bytes += stepBytes;
+    return (int)stepBytes;
+}
+/**
+ * @brief 前に流してから、lcd_MarqueeInit()で指定した間隔が過ぎていれば、１文字流す。
+ *
+ * @param pMarquee マーキー
+ * @return int 送信したバイト数。まだ間隔が過ぎていない場合は０。負の値の場合はエラー。
+ * @details メインループから繰り返し呼び出す。処理が遅れて２回分以上の時間が過ぎていた場合も、流すのは１文字だけにして、
+ * 次に流す時刻を今から数え直す（まとめて何文字も流すと、読みにくくなるため）。
+ */
+int lcd_MarqueeTick(LCDMarquee *pMarquee)
+{
+    uint64_t now = time_us_64();
+    if (now < pMarquee->nextStepUs) return 0;
+    pMarquee->nextStepUs += pMarquee->intervalUs;
+    if (pMarquee->nextStepUs <= now) {
+        pMarquee->nextStepUs = now + pMarquee->intervalUs;
+    }
+    return lcd_MarqueeStep(pMarquee);
+}
+/**
+ * @brief マーキーの統計を取得する。
+ *
+ * @param pMarquee マーキー
+ * @param pStats 統計を入れる構造体
+ */
+void lcd_MarqueeStatsGet(LCDMarquee *pMarquee, LCDMarqueeStats *pStats)
+{
+    *pStats = pMarquee->stats;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file i2cLCDMarquee.h
+ * @author Hisayuki Nomura
+ * @brief 表示のシフト命令だけで、１行の長い文字列を流し続けるマーキーのヘッダファイル。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details マーキーを使用するプログラムは、i2cLCD.hに続けてこのヘッダファイルをincludeする。\n
+ * 表示のシフトは２行同時に動くので、マーキーを使っている間は、もう一方の行も一緒に流れる。
+ * キャンバス（i2cLCDCanvas.h）やページ切り替えモードとは同時に使えない。
+ */
+#ifndef __i2cLCDMarquee_h__
+#define __i2cLCDMarquee_h__
+
+#include "i2cLCD.h"
+
+/// @brief 文字列がDDRAMの40文字より長い場合に、文字列の最後と次の周回の先頭の間に入れる空白の数
+#define LCD_MARQUEE_GAP     4
+
+/**
+ * @brief マーキーの統計。
+ */
+struct LCDMarqueeStats {
+    /// @brief １文字流した回数
+    uint32_t steps;
+    /// @brief 表示のシフト命令（２バイト）だけで済んだ回数
+    uint32_t shiftSteps;
+    /// @brief 流すときに送信したバイト数の合計。書き戻しをバックグラウンドで送信した分は含まない。
+    uint32_t bytes;
+    /// @brief 画面の外に出たカラムに、次の文字を書き戻した数
+    uint32_t refillCells;
+};
+
+/**
+ * @brief マーキー。アプリケーションが確保し、lcd_MarqueeInit()で初期化する。
+ * @details DDRAMの１行40文字を輪として使い、画面の左端のカラムleftから順に、文字列の位置headからの40文字を置いておく。
+ * １文字流すときは、表示のシフト命令で左端を１つ進め、画面の外に出たカラムに40文字先の文字を書き戻す。
+ */
+struct LCDMarquee {
+    /// @brief 流す文字列。コピーしないので、流している間は残しておく必要がある。
+    const char *pText;
+    /// @brief 文字列の長さ
+    int length;
+    /// @brief 一周の長さ。文字列が40文字以下の場合は40（空白で埋める）、長い場合は文字列の長さ＋LCD_MARQUEE_GAP。
+    int period;
+    /// @brief 流す行
+    uint8_t line;
+    /// @brief 画面の左端に表示しているDDRAMのカラム
+    uint8_t left;
+    /// @brief 画面の左端に表示している、一周の中の位置
+    int head;
+    /// @brief lcd_MarqueeTick()で流す間隔（μ秒）
+    uint32_t intervalUs;
+    /// @brief lcd_MarqueeTick()で次に流す時刻
+    uint64_t nextStepUs;
+    /// @brief 統計
+    LCDMarqueeStats stats;
+};
+
+int lcd_MarqueeInit(LCDMarquee *pMarquee, int line, const char *text, uint32_t intervalMs);
+int lcd_MarqueeStep(LCDMarquee *pMarquee);
+int lcd_MarqueeTick(LCDMarquee *pMarquee);
+void lcd_MarqueeStatsGet(LCDMarquee *pMarquee, LCDMarqueeStats *pStats);
+
+#endif
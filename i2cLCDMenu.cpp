@@ -0,0 +1,290 @@
+/**
+ * @file i2cLCDMenu.cpp
+ * @author Hisayuki Nomura
+ * @brief 設定画面などのメニュー（項目の一覧から１つを選ぶ画面）の処理。\n
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details ロータリーエンコーダーを１クリック回すたびに２行とも書き直すと、１回の操作で40バイト近くを送信することになる。
+ * メニューは、選択の移動を次のように最小の送信で行う。
+ * - 同じ画面の中での移動は、印の２文字だけ（LCD_MENU_MARKER）か、カーソルの移動だけ（LCD_MENU_CURSOR）を送信する。
+ * - 画面をまたぐ移動は、変わった文字だけを書き換える方法と、裏のページに先読みしておいた画面に表示のシフトで切り替える方法の
+ *   うち、送信にかかる時間が短い方を選ぶ（表示のシフトはisShiftを指定した場合だけ）。
+ *
+ * 項目の文字列は、液晶の文字コードのままモデルに書き込むので、変換やコピーは行わない。
+ * 次のように配列ごとconstにしておけば、文字列もポインタの配列もフラッシュに置かれ、RAMを使わない。
+ * @code
+ *  static const char * const aryMenuLabel[] = {"Contrast", "Backlight", "\xB5\xDD\xD8\xAE\xB3", "Reset"};
+ *  static LCDMenu menu;
+ *  lcd_MenuInit(&menu, aryMenuLabel, 4, LCD_MENU_MARKER, true);
+ *  while (true) {
+ *      int delta = readEncoder();
+ *      if (delta != 0) lcd_MenuMove(&menu, delta);
+ *      lcd_flush_step(500);                // 裏のページの先読みを送信する
+ *  }
+ * @endcode
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "i2cLCD.h"
+#include "i2cLCDlocal.h"
+#include "i2cLCDMenu.h"
+
+/**
+ * @brief 表示しているページの先頭のDDRAMのカラムを求める。
+ *
+ * @param pMenu メニュー
+ * @return int ページ切り替えモードを使う場合は、表示しているページの先頭のカラム。使わない場合は０。
+ */
+static int lcd_MenuFrontColumn(LCDMenu *pMenu)
+{
+    return pMenu->isShift ? lcdModel.frontPage * MAX_CHARS : 0;
+}
+/**
+ * @brief 画面の１行分の表示内容を作る。
+ *
+ * @param pMenu メニュー
+ * @param item 表示する項目。項目の数以上の場合は空白の行。
+ * @param selected 選択している項目
+ * @param aryRow 表示内容を入れるバッファ（MAX_CHARSバイト）
+ */
+static void lcd_MenuRow(LCDMenu *pMenu, int item, int selected, char *aryRow)
+{
+    memset(aryRow, ' ', MAX_CHARS);
+    if (item >= pMenu->count) return;
+    if (pMenu->style == LCD_MENU_MARKER && item == selected) {
+        aryRow[0] = LCD_MENU_MARKER_CHAR;
+    }
+    const char *pLabel = pMenu->aryLabel[item];
+    for (int i = 0; i < MAX_CHARS - 1 && pLabel[i] != '\0'; i++) {
+        aryRow[1 + i] = pLabel[i];
+    }
+}
+/**
+ * @brief 画面１つ分を、モデルのカラムcolumnからに書き込む。液晶にはまだ送信されない。
+ *
+ * @param pMenu メニュー
+ * @param column 書き込む先頭のDDRAMのカラム
+ * @param top 画面の１行目の項目
+ * @param selected 選択している項目
+ * @param pri 送信の優先度
+ */
+static void lcd_MenuDraw(LCDMenu *pMenu, int column, int top, int selected, LCD_PRIORITY pri)
+{
+    char aryRow[MAX_CHARS];
+    for (int line = 0; line < MAX_LINES; line++) {
+        lcd_MenuRow(pMenu, top + line, selected, aryRow);
+        lcd_ModelWrite(line, column, aryRow, MAX_CHARS, pri);
+    }
+}
+/**
+ * @brief 画面１つ分を、モデルのカラムcolumnからの内容と比べて、書き換えるのに送信するバイト数を見積もる。
+ *
+ * @param pMenu メニュー
+ * @param column 比べる先頭のDDRAMのカラム
+ * @param top 画面の１行目の項目
+ * @param selected 選択している項目
+ * @param pLines 書き換える行の数（トランザクションの数）を入れる
+ * @return int 送信するバイト数。行ごとに、最初に変わる文字から最後に変わる文字までを１回で送る（3＋文字数バイト）として見積もる。
+ */
+static int lcd_MenuDiffBytes(LCDMenu *pMenu, int column, int top, int selected, int *pLines)
+{
+    char aryRow[MAX_CHARS];
+    int bytes = 0;
+    *pLines = 0;
+    for (int line = 0; line < MAX_LINES; line++) {
+        lcd_MenuRow(pMenu, top + line, selected, aryRow);
+        int from = -1;
+        int to = -1;
+        for (int i = 0; i < MAX_CHARS; i++) {
+            if (lcd_ModelGet(line, column + i) != (uint8_t)aryRow[i]) {
+                if (from < 0) from = i;
+                to = i;
+            }
+        }
+        if (from >= 0) {
+            bytes += 3 + (to - from + 1);
+            (*pLines)++;
+        }
+    }
+    return bytes;
+}
+/**
+ * @brief カーソルを、選択している項目の行の先頭に合わせる。
+ *
+ * @param pMenu メニュー
+ * @return int 送信したバイト数。カーソルを使わない場合や、既にその位置にある場合は０。負の値の場合はエラー。
+ * @details lcd_Flush()などは送信の最後にカーソルを元の位置に戻すので、送信の前に呼び出しておくと、戻す先が新しい位置になる。
+ * その場合は、送信の後にもう一度呼び出しても何も送信されない。
+ */
+static int lcd_MenuCursorSync(LCDMenu *pMenu)
+{
+    if (pMenu->style != LCD_MENU_CURSOR) return 0;
+    int line = pMenu->selected - pMenu->top;
+    int column = lcd_MenuFrontColumn(pMenu);
+    lcdSetting.curPosLine = line;
+    lcdSetting.curPosColumn = column;
+    if (lcdSetting.hwAddr == lcd_DDRAMAddr(line, column)) return 0;
+    return lcd_CursorAddrSet(line, column);
+}
+/**
+ * @brief 次に表示しそうな画面を、裏のページに先読みする。液晶にはまだ送信されない。
+ *
+ * @param pMenu メニュー
+ * @param direction 最後に選択を動かした向き。正の値の場合は次の画面を、負の値の場合は前の画面を先読みする。
+ * @details 先読みはLCD_PRI_BULKでモデルに書き込み、lcd_flush_step()などのバックグラウンドの送信に任せる。
+ * 印は、その画面に移ったときに選択されるはずの項目（次の画面なら１行目、前の画面なら最後の行）に付けておく。
+ */
+static void lcd_MenuPrefetch(LCDMenu *pMenu, int direction)
+{
+    if (!pMenu->isShift) return;
+    int next = (direction >= 0) ? pMenu->top + MAX_LINES : pMenu->top - MAX_LINES;
+    if (next < 0 || next >= pMenu->count) {
+        next = (direction >= 0) ? pMenu->top - MAX_LINES : pMenu->top + MAX_LINES;
+    }
+    if (next < 0 || next >= pMenu->count) return;
+    int selected = (next > pMenu->top) ? next : next + MAX_LINES - 1;
+    if (selected >= pMenu->count) selected = pMenu->count - 1;
+    lcd_MenuDraw(pMenu, MAX_CHARS - lcd_MenuFrontColumn(pMenu), next, selected, LCD_PRI_BULK);
+    pMenu->backTop = next;
+}
+/**
+ * @brief メニューを初期化し、最初の項目を選択した画面を表示する。
+ *
+ * @param pMenu メニュー
+ * @param aryLabel 項目の表示文字列の配列。コピーしないので、メニューを使っている間は残しておく必要がある。
+ * 各行の先頭は印に使うので、表示されるのはMAX_CHARS-1文字まで。
+ * @param count 項目の数
+ * @param style 選択している項目の示し方
+ * @param isShift trueの場合は、ページ切り替えモード（lcd_PageFlipMode）を開始し、表示のシフトでも画面を切り替える。
+ * @return int 送信したバイト数。負の値の場合はエラー。引数が正しくない場合は-1。
+ * @details LCD_MENU_CURSORの場合はカーソルを点滅で表示し、LCD_MENU_MARKERの場合はカーソルを消す。
+ */
+int lcd_MenuInit(LCDMenu *pMenu, const char * const *aryLabel, int count, LCD_MENU_STYLE style, bool isShift)
+{
+    if (aryLabel == NULL || count <= 0) return -1;
+    memset(pMenu, 0, sizeof(LCDMenu));
+    pMenu->aryLabel = aryLabel;
+    pMenu->count = count;
+    pMenu->backTop = -1;
+    pMenu->style = style;
+    pMenu->isShift = isShift;
+    int iSendBytes = 0;
+    int iRet;
+    if (isShift && !lcdModel.isPageFlip) {
+        iRet = lcd_PageFlipMode(true);
+        if (iRet < 0) return iRet;
+        iSendBytes += iRet;
+    }
+    iRet = lcd_CursorMode(true, false, style == LCD_MENU_CURSOR);
+    if (iRet < 0) return iRet;
+    iSendBytes += iRet;
+    lcd_MenuDraw(pMenu, lcd_MenuFrontColumn(pMenu), 0, 0, LCD_PRI_NORMAL);
+    lcd_MenuCursorSync(pMenu);
+    iRet = lcd_FlushPriority(LCD_PRI_NORMAL);
+    if (iRet < 0) return iRet;
+    iSendBytes += iRet;
+    iRet = lcd_MenuCursorSync(pMenu);
+    if (iRet < 0) return iRet;
+    iSendBytes += iRet;
+    lcd_MenuPrefetch(pMenu, 1);
+    return iSendBytes;
+}
+/**
+ * @brief 項目を選択する。
+ *
+ * @param pMenu メニュー
+ * @param index 選択する項目。範囲外の場合は、最初か最後の項目にする。
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ * @details 同じ画面の中の項目の場合は、印の２文字か、カーソルの移動だけを送信する。\n
+ * 別の画面の項目の場合は、変わった文字だけを書き換えるのにかかる時間と、裏のページに先読みしてある画面に表示のシフトで
+ * 切り替えるのにかかる時間（先読みが送信済みの場合だけ）を比べ、短い方で切り替える。
+ * ページ１へのシフトは16命令（32バイト）、ページ０へはReturnHome（２バイトだが実行に時間がかかる）になる。
+ */
+int lcd_MenuSelect(LCDMenu *pMenu, int index)
+{
+    if (index < 0) index = 0;
+    if (index >= pMenu->count) index = pMenu->count - 1;
+    if (index == pMenu->selected) return 0;
+    uint32_t startBytes = lcdSetting.busStats.bytes;
+    int direction = (index > pMenu->selected) ? 1 : -1;
+    int previous = pMenu->selected;
+    int top = index - index % MAX_LINES;
+    int front = lcd_MenuFrontColumn(pMenu);
+    int iRet;
+    pMenu->selected = index;
+    if (top == pMenu->top) {
+        if (pMenu->style == LCD_MENU_MARKER) {
+            lcd_ModelWrite(previous - top, front, " ", 1);
+            char marker = LCD_MENU_MARKER_CHAR;
+            lcd_ModelWrite(index - top, front, &marker, 1);
+            iRet = lcd_FlushPriority(LCD_PRI_NORMAL);
+        } else {
+            iRet = lcd_MenuCursorSync(pMenu);
+        }
+        if (iRet < 0) return iRet;
+        pMenu->stats.markerSteps++;
+    } else {
+        int diffLines;
+        int diffBytes = lcd_MenuDiffBytes(pMenu, front, top, index, &diffLines);
+        uint32_t diffUs = lcd_BusTimeUs(diffBytes) + diffLines * CMD_DELAY;
+        bool isFlip = false;
+        if (pMenu->isShift && pMenu->backTop == top && lcd_PageReady()) {
+            // 裏のページの印が予想と違う場合は、その修正も切り替えの費用に含める
+            int fixLines;
+            int fixBytes = lcd_MenuDiffBytes(pMenu, MAX_CHARS - front, top, index, &fixLines);
+            uint32_t flipUs = (front == 0) ? lcd_BusTimeUs(MAX_CHARS * 2) + CMD_DELAY : lcd_BusTimeUs(2) + CMD_DELAY_LONG;
+            flipUs += lcd_BusTimeUs(fixBytes) + fixLines * CMD_DELAY;
+            isFlip = (flipUs < diffUs);
+        }
+        pMenu->top = top;
+        if (isFlip) {
+            lcd_MenuDraw(pMenu, MAX_CHARS - front, top, index, LCD_PRI_NORMAL);
+            iRet = lcd_PageFlip();
+            if (iRet < 0) return iRet;
+            pMenu->stats.shiftPages++;
+        } else {
+            lcd_MenuDraw(pMenu, front, top, index, LCD_PRI_NORMAL);
+            lcd_MenuCursorSync(pMenu);
+            iRet = lcd_FlushPriority(LCD_PRI_NORMAL);
+            if (iRet < 0) return iRet;
+            pMenu->stats.diffPages++;
+        }
+        iRet = lcd_MenuCursorSync(pMenu);
+        if (iRet < 0) return iRet;
+        lcd_MenuPrefetch(pMenu, direction);
+    }
+    uint32_t stepBytes = lcdSetting.busStats.bytes - startBytes;
+    pMenu->stats.steps++;
+    pMenu->stats.bytes += stepBytes;
+    pMenu->stats.lastStepBytes = stepBytes;
+    return (int)stepBytes;
+}
+/**
+ * @brief 選択を、指定された数だけ上下に動かす。ロータリーエンコーダーの回転などに使う。
+ *
+ * @param pMenu メニュー
+ * @param delta 動かす数。正の値の場合は下（後ろの項目）に、負の値の場合は上に動かす。
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ */
+int lcd_MenuMove(LCDMenu *pMenu, int delta)
+{
+    return lcd_MenuSelect(pMenu, pMenu->selected + delta);
+}
+/**
+ * @brief メニューの統計を取得する。
+ *
+ * @param pMenu メニュー
+ * @param pStats 統計を入れる構造体
+ */
+void lcd_MenuStatsGet(LCDMenu *pMenu, LCDMenuStats *pStats)
+{
+    *pStats = pMenu->stats;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file i2cLCDMenu.h
+ * @author Hisayuki Nomura
+ * @brief 設定画面などのメニュー（項目の一覧から１つを選ぶ画面）のヘッダファイル。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details メニューを使用するプログラムは、i2cLCD.hに続けてこのヘッダファイルをincludeする。\n
+ * メニューは画面全体を使用し、１画面にMAX_LINES個の項目を表示する。各行の先頭のカラムは、選択している項目の印（またはカーソル）に使う。
+ */
+#ifndef __i2cLCDMenu_h__
+#define __i2cLCDMenu_h__
+
+#include "i2cLCD.h"
+
+/// @brief 選択している項目の行の先頭に表示する印
+#define LCD_MENU_MARKER_CHAR    '>'
+
+/**
+ * @brief 選択している項目の示し方。
+ */
+enum LCD_MENU_STYLE : uint8_t {
+    /// @brief 行の先頭に印（LCD_MENU_MARKER_CHAR）を表示する。同じ画面の中で選択を動かすと、印の２文字だけを書き換える。
+    LCD_MENU_MARKER,
+    /// @brief 行の先頭に液晶のカーソル（点滅）を表示する。同じ画面の中で選択を動かすと、カーソルの移動（２バイト）だけになる。
+    LCD_MENU_CURSOR,
+};
+
+/**
+ * @brief メニューの操作の統計。
+ */
+struct LCDMenuStats {
+    /// @brief 選択を動かした回数
+    uint32_t steps;
+    /// @brief 同じ画面の中で、印かカーソルだけを動かした回数
+    uint32_t markerSteps;
+    /// @brief 画面を変わった項目だけの書き換えで切り替えた回数
+    uint32_t diffPages;
+    /// @brief 画面を表示のシフト（ページ切り替え）で切り替えた回数
+    uint32_t shiftPages;
+    /// @brief 選択を動かすときに送信したバイト数の合計。裏のページの先読みをバックグラウンドで送信した分は含まない。
+    uint32_t bytes;
+    /// @brief 最後に選択を動かしたときに送信したバイト数
+    uint32_t lastStepBytes;
+};
+
+/**
+ * @brief メニュー。アプリケーションが確保し、lcd_MenuInit()で初期化する。
+ */
+struct LCDMenu {
+    /// @brief 項目の表示文字列の配列。液晶の文字コードのまま表示するので、カナなどは液晶の文字コードで用意しておく。
+    const char * const *aryLabel;
+    /// @brief 項目の数
+    int count;
+    /// @brief 選択している項目
+    int selected;
+    /// @brief 画面の１行目に表示している項目
+    int top;
+    /// @brief 裏のページに先読みしてある画面の１行目の項目。先読みしていない場合は-1。
+    int backTop;
+    /// @brief 選択している項目の示し方
+    LCD_MENU_STYLE style;
+    /// @brief trueの場合は、ページ切り替えモードを使い、表示のシフトでも画面を切り替える。
+    bool isShift;
+    /// @brief 統計
+    LCDMenuStats stats;
+};
+
+int lcd_MenuInit(LCDMenu *pMenu, const char * const *aryLabel, int count, LCD_MENU_STYLE style, bool isShift);
+int lcd_MenuSelect(LCDMenu *pMenu, int index);
+int lcd_MenuMove(LCDMenu *pMenu, int delta);
+void lcd_MenuStatsGet(LCDMenu *pMenu, LCDMenuStats *pStats);
+
+#endif
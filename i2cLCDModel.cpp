@@ -0,0 +1,1609 @@
+/**
+ * @file i2cLCDModel.cpp
+ * @author Hisayuki Nomura
+ * @brief 液晶に表示する内容をRAM上に持ち、変更のあった部分だけを液晶に送信するための処理。\n
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details lcd_stringやlcd_printfは、呼び出されるたびにすぐにI2Cで液晶に送信する。同じ場所を何度も書き換えるような場合や、
+ * 画面のあちこちを少しずつ書き換えるような場合には、この送信に時間がかかる。\n
+ * このファイルの関数を使うと、まず表示したい内容をRAM上のモデル（DDRAMの写し）に書き込み、液晶に送信済みの内容と比較して、
+ * 異なる部分だけをまとめて送信する。送信はlcd_Flush()で一度に行うか、lcd_flush_step()で、決められた時間内に少しずつ行う。\n
+ * lcd_flush_step()は、１回の呼び出しで指定された時間以上はI2Cの送信や液晶の待ち時間に使わないので、
+ * 制御ループなどの中から呼び出しても、ループの周期を乱さない。
+ *
+ * @code
+ *  lcd_ModelWrite(0, 0, "TEMP:", -1);
+ *  while (true) {
+ *      control_loop();                     // 1kHzの制御
+ *      lcd_flush_step(100);                // 1回あたり100μ秒までしか液晶に使わない
+ *  }
+ * @endcode
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "i2cLCD.h"
+#include "i2cLCDlocal.h"
+
+
+/**
+ * @brief 液晶に表示する内容のモデルの実体。
+ * @details 詳細は、i2cLCDlocal.hのデータ構造を参照。
+ */
+struct LCDModel lcdModel;
+
+/**
+ * @brief 指定された範囲を、未送信のセルがあるかもしれない範囲に加える。
+ *
+ * @param line 行
+ * @param from 範囲の先頭カラム
+ * @param to 範囲の末尾カラム+1
+ */
+static void lcd_ModelMarkDirty(int line, int from, int to)
+{
+    if (lcdModel.aryDirtyFrom[line] >= lcdModel.aryDirtyTo[line]) {
+        lcdModel.aryDirtyFrom[line] = from;
+        lcdModel.aryDirtyTo[line] = to;
+    } else {
+        if (from < lcdModel.aryDirtyFrom[line]) lcdModel.aryDirtyFrom[line] = from;
+        if (to > lcdModel.aryDirtyTo[line]) lcdModel.aryDirtyTo[line] = to;
+    }
+}
+/**
+ * @brief セルが未送信かどうかを調べる。
+ *
+ * @param line 行
+ * @param col カラム
+ * @return bool 未送信の場合はtrue。送信済みの内容と異なるか、lcd_ModelRefresh()で再送信を指定されている場合。
+ */
+static inline bool lcd_ModelCellDirty(int line, int col)
+{
+    return lcdModel.aryCell[line][col] != lcdModel.arySent[line][col] || (lcdModel.aryLane[line][col] & LCD_LANE_FORCE);
+}
+/**
+ * @brief セルに１文字書き込み、未送信になった場合は優先度と時刻を記録する。
+ *
+ * @param line 行
+ * @param col カラム
+ * @param val 書き込む文字
+ * @param pri 優先度
+ * @details 既に未送信のセルに、より高い優先度で書き込んだ場合は、優先度だけを上げる。未送信になった時刻は、最初に書き込まれた時刻のまま。
+ */
+static void lcd_ModelSetCell(int line, int col, uint8_t val, uint8_t pri)
+{
+    bool wasDirty = lcd_ModelCellDirty(line, col);
+    if (lcdModel.aryCell[line][col] != val) {
+        lcdModel.frameStats.writes++;
+        if (wasDirty) lcdModel.frameStats.coalesced++;     // 送信される前の内容は捨てられる
+    }
+    lcdModel.aryCell[line][col] = val;
+    if (!lcd_ModelCellDirty(line, col)) return;
+    if (!wasDirty) {
+        lcdModel.aryLane[line][col] = pri;
+        lcdModel.aryStamp[line][col] = time_us_32();
+    } else if ((lcdModel.aryLane[line][col] & LCD_LANE_MASK) < pri) {
+        lcdModel.aryLane[line][col] = (lcdModel.aryLane[line][col] & LCD_LANE_FORCE) | pri;
+    }
+}
+
+/**
+ * @brief セルに表示する文字を、下の内容と、その上に表示しているオーバーレイを重ね合わせて求める。
+ *
+ * @param line 行
+ * @param col カラム
+ * @return uint8_t 一番上にあるオーバーレイの文字。どのオーバーレイにも覆われていない場合は下の内容(aryBase)。
+ * 下の内容が点滅するセルで、消えている側の半周期の場合は空白。
+ */
+static uint8_t lcd_ModelComposite(int line, int col)
+{
+    for (int i = lcdModel.overlayCount - 1; i >= 0; i--) {
+        LCDOverlay *pOv = lcdModel.aryOverlay[i];
+        int r = line - pOv->line;
+        int c = col - pOv->column;
+        if (r >= 0 && r < pOv->height && c >= 0 && c < pOv->width) {
+            return (uint8_t)pOv->pCells[r * pOv->width + c];
+        }
+    }
+    if (lcdModel.isBlinkOff && (lcdModel.aryBlinkMask[line] & ((uint64_t)1 << col))) return ' ';
+    return lcdModel.aryBase[line][col];
+}
+/**
+ * @brief 下の内容のセルに１文字書き込み、重ね合わせた結果をセルに反映する。
+ *
+ * @param line 行
+ * @param col カラム
+ * @param val 書き込む文字
+ * @param pri 優先度
+ * @details オーバーレイに覆われているセルや、点滅で消えているセルは、下の内容だけが変わり、表示する文字は変わらない。
+ */
+static void lcd_ModelPut(int line, int col, uint8_t val, uint8_t pri)
+{
+    lcdModel.aryBase[line][col] = val;
+    bool isPlain = (lcdModel.overlayCount == 0 && !lcdModel.isBlinkOff);
+    lcd_ModelSetCell(line, col, isPlain ? val : lcd_ModelComposite(line, col), pri);
+}
+
+/**
+ * @brief 表示内容のモデルに文字列を書き込む。液晶にはまだ送信されない。
+ *
+ * @param line 行　（0～MAX_LINES-1）
+ * @param column カラム（０～DDRAM_CHARS-1）。MAX_CHARS以上のカラムは、画面外のDDRAMになる。
+ * @param s 書き込む文字列
+ * @param length 書き込む長さ。負の値の場合は文字列の長さ（NULL文字まで）。ヌル文字も書き込める。
+ * @param pri 送信の優先度。優先度の高い更新から送信される。
+ * @return int 書き込んだ文字数。DDRAM_CHARSを超えた部分は捨てられる。行やカラムが範囲外の場合は-1。
+ * @details 書き込んだ内容は、lcd_Flush()かlcd_flush_step()で液晶に送信される。送信済みの内容と同じ文字を書き込んだ場合は、送信されない。
+ */
+int lcd_ModelWrite(int line, int column, const char *s, int length, LCD_PRIORITY pri)
+{
+    if (line < 0 || line >= MAX_LINES || column < 0 || column >= DDRAM_CHARS) return -1;
+    if (length < 0) {
+        length = strlen(s);
+    }
+    if (length > DDRAM_CHARS - column) {
+        length = DDRAM_CHARS - column;
+    }
+    if (length == 0) return 0;
+    for (int i = 0; i < length; i++) {
+        lcd_ModelPut(line, column + i, (uint8_t)s[i], pri);
+    }
+    lcd_ModelMarkDirty(line, column, column + length);
+    return length;
+}
+/**
+ * @brief 表示内容のモデルに、通常の優先度(LCD_PRI_NORMAL)で文字列を書き込む。液晶にはまだ送信されない。
+ *
+ * @param line 行　（0～MAX_LINES-1）
+ * @param column カラム（０～DDRAM_CHARS-1）。MAX_CHARS以上のカラムは、画面外のDDRAMになる。
+ * @param s 書き込む文字列
+ * @param length 書き込む長さ。負の値の場合は文字列の長さ（NULL文字まで）。ヌル文字も書き込める。
+ * @return int 書き込んだ文字数。DDRAM_CHARSを超えた部分は捨てられる。行やカラムが範囲外の場合は-1。
+ */
+int lcd_ModelWrite(int line, int column, const char *s, int length)
+{
+    return lcd_ModelWrite(line, column, s, length, LCD_PRI_NORMAL);
+}
+/**
+ * @brief 表示内容のモデルを、指定された文字で埋める。液晶にはまだ送信されない。
+ *
+ * @param line 行　（0～MAX_LINES-1）
+ * @param column 先頭のカラム（０～DDRAM_CHARS-1）
+ * @param c 埋める文字
+ * @param count 埋める文字数
+ * @param pri 送信の優先度
+ * @return int 書き込んだ文字数。行やカラムが範囲外の場合は-1。
+ */
+int lcd_ModelFill(int line, int column, char c, int count, LCD_PRIORITY pri)
+{
+    if (line < 0 || line >= MAX_LINES || column < 0 || column >= DDRAM_CHARS) return -1;
+    if (count > DDRAM_CHARS - column) {
+        count = DDRAM_CHARS - column;
+    }
+    if (count <= 0) return 0;
+    for (int i = 0; i < count; i++) {
+        lcd_ModelPut(line, column + i, (uint8_t)c, pri);
+    }
+    lcd_ModelMarkDirty(line, column, column + count);
+    return count;
+}
+/**
+ * @brief 表示内容のモデルを、通常の優先度で、指定された文字で埋める。液晶にはまだ送信されない。
+ *
+ * @param line 行　（0～MAX_LINES-1）
+ * @param column 先頭のカラム（０～DDRAM_CHARS-1）
+ * @param c 埋める文字
+ * @param count 埋める文字数
+ * @return int 書き込んだ文字数。行やカラムが範囲外の場合は-1。
+ */
+int lcd_ModelFill(int line, int column, char c, int count)
+{
+    return lcd_ModelFill(line, column, c, count, LCD_PRI_NORMAL);
+}
+/**
+ * @brief 表示内容のモデルを、すべて空白にする。
+ *
+ * @return int 常に０
+ * @details lcd_ClearDisplay()と異なり、液晶には何も送信しない。次のlcd_Flush()で、空白でなかった部分だけが空白で上書きされる。
+ */
+int lcd_ModelClear(void)
+{
+    for (int line = 0; line < MAX_LINES; line++) {
+        lcd_ModelFill(line, 0, ' ', DDRAM_CHARS);
+    }
+    return 0;
+}
+/**
+ * @brief 画面全体を、送信済みの内容と同じでも再送信するように指定する。
+ *
+ * @param pri 再送信の優先度。通常はLCD_PRI_BULKを指定する。
+ * @return int 常に０
+ * @details ノイズなどで液晶の表示が崩れた場合に使用する。再送信はLCD_BULK_RUN_MAX文字ずつのトランザクションに区切られるので、
+ * 送信中に、より優先度の高い更新が書き込まれた場合はそちらが先に送信される。
+ */
+int lcd_ModelRefresh(LCD_PRIORITY pri)
+{
+    uint32_t now = time_us_32();
+    for (int line = 0; line < MAX_LINES; line++) {
+        for (int col = 0; col < DDRAM_CHARS; col++) {
+            uint8_t lane = lcdModel.aryLane[line][col];
+            if (!lcd_ModelCellDirty(line, col)) {
+                lane = pri;
+                lcdModel.aryStamp[line][col] = now;
+            } else if ((lane & LCD_LANE_MASK) < pri) {
+                lane = pri;
+            }
+            lcdModel.aryLane[line][col] = lane | LCD_LANE_FORCE;
+        }
+        lcd_ModelMarkDirty(line, 0, DDRAM_CHARS);
+    }
+    return 0;
+}
+/**
+ * @brief 表示内容のモデルから、指定された位置の文字を取り出す。
+ *
+ * @param line 行
+ * @param column カラム
+ * @return uint8_t モデル上の文字。まだ送信されていない場合もある。範囲外の場合は空白。
+ * @details オーバーレイ（lcd_OverlayShow）を表示している場合も、オーバーレイの下の内容を返す。
+ */
+uint8_t lcd_ModelGet(int line, int column)
+{
+    if (line < 0 || line >= MAX_LINES || column < 0 || column >= DDRAM_CHARS) return ' ';
+    return lcdModel.aryBase[line][column];
+}
+
+#if LCD_ICONEXIST
+/**
+ * @brief アイコンのアドレスに、今表示したい値を求める。
+ *
+ * @param iconAddr アイコンのアドレス
+ * @return uint8_t aryIconCellの値。点滅が消えている側の半周期の場合は、点滅するビットを落とした値。
+ */
+static inline uint8_t lcd_ModelIconWanted(int iconAddr)
+{
+    return lcdModel.isBlinkOff ? (lcdModel.aryIconCell[iconAddr] & ~lcdModel.aryIconBlink[iconAddr]) : lcdModel.aryIconCell[iconAddr];
+}
+/**
+ * @brief アイコンのアドレスが未送信になった場合に、優先度と時刻を記録する。
+ *
+ * @param iconAddr アイコンのアドレス
+ * @param wasDirty 変更する前に未送信だった場合はtrue
+ * @param pri 優先度
+ */
+static void lcd_ModelIconTouch(int iconAddr, bool wasDirty, uint8_t pri)
+{
+    if (lcd_ModelIconWanted(iconAddr) == lcdSetting.aryIconValue[iconAddr]) return;
+    if (!wasDirty) {
+        lcdModel.aryIconLane[iconAddr] = pri;
+        lcdModel.aryIconStamp[iconAddr] = time_us_32();
+    } else if (lcdModel.aryIconLane[iconAddr] < pri) {
+        lcdModel.aryIconLane[iconAddr] = pri;
+    }
+}
+/**
+ * @brief 表示内容のモデルで、アイコンをオン/オフする。液晶にはまだ送信されない。
+ *
+ * @param isDisp 表示するか、消去するかのフラグ。trueのときはアイコンを表示
+ * @param icon 操作するアイコン。
+ * @param pri 送信の優先度
+ * @return int 常に０
+ * @details lcd_IconSet()と異なり、lcd_Flush()などで、文字の更新と一緒に優先度の順に送信される。
+ * 同じ優先度の未送信のアイコンは、１回のトランザクションでまとめて送信される。
+ */
+int lcd_ModelIconSet(bool isDisp, LCD_ICON icon, LCD_PRIORITY pri)
+{
+    uint8_t iconAddr = (uint8_t)((icon >> 8) & 0x0F);
+    uint8_t iconBits = (uint8_t)(icon & 0xFF);
+    bool wasDirty = lcd_ModelIconWanted(iconAddr) != lcdSetting.aryIconValue[iconAddr];
+    if (isDisp) {
+        lcdModel.aryIconCell[iconAddr] |= iconBits;
+    } else {
+        lcdModel.aryIconCell[iconAddr] &= ~iconBits;
+    }
+    lcd_ModelIconTouch(iconAddr, wasDirty, pri);
+    return 0;
+}
+/**
+ * @brief 表示内容のモデルで、通常の優先度でアイコンをオン/オフする。液晶にはまだ送信されない。
+ *
+ * @param isDisp 表示するか、消去するかのフラグ。trueのときはアイコンを表示
+ * @param icon 操作するアイコン。
+ * @return int 常に０
+ */
+int lcd_ModelIconSet(bool isDisp, LCD_ICON icon)
+{
+    return lcd_ModelIconSet(isDisp, icon, LCD_PRI_NORMAL);
+}
+/**
+ * @brief lcd_IconSetなどで直接液晶に送信したアイコンの変更を、モデルに反映する。
+ *
+ * @param iconAddr アイコンのアドレス
+ * @param bits 変更したビット
+ * @param isDisp 表示した場合はtrue、消去した場合はfalse
+ * @details 変更したビットだけをモデルに反映する。送信した値をそのまま書き込むと、同じアドレスのlcd_ModelIconSet()で
+ * まだ送信していないビットや、点滅が消えている側の半周期で送信していないビットが、モデルから消えてしまうため。
+ */
+void lcd_ModelMirrorIcon(uint8_t iconAddr, uint8_t bits, bool isDisp)
+{
+    if (isDisp) {
+        lcdModel.aryIconCell[iconAddr & 0x0F] |= bits;
+    } else {
+        lcdModel.aryIconCell[iconAddr & 0x0F] &= ~bits;
+    }
+}
+#endif
+
+/**
+ * @brief 未送信のセルやアイコンのうち、最も高い優先度を求める。
+ *
+ * @return int 最も高い優先度。未送信のものが無い場合は-1。
+ * @details 行ごとの未送信の範囲は、ここで両端の送信済みのセルを除いて縮める。
+ */
+static int lcd_ModelPendingLane(void)
+{
+    int lane = -1;
+    for (int line = 0; line < MAX_LINES; line++) {
+        int from = lcdModel.aryDirtyFrom[line];
+        int to = lcdModel.aryDirtyTo[line];
+        while (from < to && !lcd_ModelCellDirty(line, from)) from++;
+        while (to > from && !lcd_ModelCellDirty(line, to - 1)) to--;
+        lcdModel.aryDirtyFrom[line] = (from < to) ? from : 0;
+        lcdModel.aryDirtyTo[line] = (from < to) ? to : 0;
+        for (int col = from; col < to; col++) {
+            if (lcd_ModelCellDirty(line, col) && (lcdModel.aryLane[line][col] & LCD_LANE_MASK) > lane) {
+                lane = lcdModel.aryLane[line][col] & LCD_LANE_MASK;
+            }
+        }
+    }
+#if LCD_ICONEXIST
+    for (int i = 0; i < 16; i++) {
+        if (lcd_ModelIconWanted(i) != lcdSetting.aryIconValue[i] && lcdModel.aryIconLane[i] > lane) {
+            lane = lcdModel.aryIconLane[i];
+        }
+    }
+#endif
+    return lane;
+}
+/**
+ * @brief 表示内容のモデルに、まだ液晶に送信していない部分があるかを調べる。
+ *
+ * @return bool 未送信の部分（文字かアイコン）がある場合はtrue
+ */
+bool lcd_ModelIsDirty(void)
+{
+    return lcd_ModelPendingLane() >= 0;
+}
+/**
+ * @brief 送信が完了したセルの待ち時間を、優先度ごとの統計に加える。
+ *
+ * @param lane セルの優先度
+ * @param stamp セルが未送信になった時刻
+ * @param now 送信が完了した時刻
+ */
+static void lcd_ModelRecordLatency(int lane, uint32_t stamp, uint32_t now)
+{
+    LCDLatencyStats *pStats = &lcdModel.aryLatency[lane & LCD_LANE_MASK];
+    uint32_t latency = now - stamp;
+    pStats->count++;
+    pStats->totalUs += latency;
+    if (latency > pStats->maxUs) pStats->maxUs = latency;
+}
+
+/**
+ * @brief オーバーレイの矩形の中のセルを、重ね合わせ直す。
+ *
+ * @param pOv オーバーレイ
+ * @param pri 変わったセルを送信する優先度
+ * @details 重ね合わせた結果が送信済みの内容と同じセルは、送信されない。
+ */
+static void lcd_ModelOverlayComposite(LCDOverlay *pOv, uint8_t pri)
+{
+    for (int r = 0; r < pOv->height; r++) {
+        int line = pOv->line + r;
+        for (int c = 0; c < pOv->width; c++) {
+            lcd_ModelSetCell(line, pOv->column + c, lcd_ModelComposite(line, pOv->column + c), pri);
+        }
+        lcd_ModelMarkDirty(line, pOv->column, pOv->column + pOv->width);
+    }
+}
+
+/**
+ * @brief 直接液晶に書き込んだ内容を、モデルに反映する。lcd_stringなどから呼び出される。
+ *
+ * @param line 書き込んだ行
+ * @param column 書き込んだカラム
+ * @param buf 書き込んだデータ
+ * @param length 書き込んだ長さ
+ * @details 液晶のアドレスカウンタと同じように、行の最後(DDRAM_CHARS)を超えると次の行の先頭に折り返す。
+ * 直接書き込んだ内容は、送信済みとして扱う。
+ */
+void lcd_ModelMirror(int line, int column, const uint8_t *buf, int length)
+{
+    for (int i = 0; i < length; i++) {
+        if (column >= DDRAM_CHARS) {
+            column = 0;
+            line = (line + 1) % 2;
+        }
+        if (line < MAX_LINES) {
+            lcdModel.aryBase[line][column] = buf[i];
+            lcdModel.arySent[line][column] = buf[i];
+            lcdModel.aryLane[line][column] = 0;
+            lcdModel.aryCell[line][column] = buf[i];
+            if (lcdModel.overlayCount > 0 || lcdModel.isBlinkOff) {    // オーバーレイや点滅で消えているセルに書いてしまった場合は、次の送信で書き直す
+                lcd_ModelSetCell(line, column, lcd_ModelComposite(line, column), LCD_PRI_NORMAL);
+                lcd_ModelMarkDirty(line, column, column + 1);
+            }
+        }
+        column++;
+    }
+}
+/**
+ * @brief lcd_ClearDisplayで液晶が消去されたことを、モデルに反映する。
+ */
+void lcd_ModelMirrorClear(void)
+{
+    memset(lcdModel.aryBase, ' ', sizeof(lcdModel.aryBase));
+    memset(lcdModel.aryCell, ' ', sizeof(lcdModel.aryCell));
+    memset(lcdModel.arySent, ' ', sizeof(lcdModel.arySent));
+    memset(lcdModel.aryLane, 0, sizeof(lcdModel.aryLane));
+    for (int line = 0; line < MAX_LINES; line++) {
+        lcdModel.aryDirtyFrom[line] = 0;
+        lcdModel.aryDirtyTo[line] = 0;
+    }
+    for (int i = 0; i < lcdModel.overlayCount; i++) {
+        lcd_ModelOverlayComposite(lcdModel.aryOverlay[i], LCD_PRI_NORMAL);
+    }
+}
+
+/**
+ * @brief 指定された優先度の、次に送信する未送信のセルの連続した範囲（ラン）を探す。
+ *
+ * @param lane 探す優先度
+ * @param pLine 見つかった行
+ * @param pFrom 見つかった範囲の先頭カラム
+ * @param pLength 見つかった範囲の長さ
+ * @return bool 見つかった場合はtrue。その優先度の未送信のセルが無い場合はfalse。
+ * @details 未送信のセルの間に、送信済みのセルがLCD_RUN_MERGE_GAP個以下しかない場合は、まとめて１つのランにする。
+ * 間に優先度の低い未送信のセルがあった場合は、それも一緒に送信される。\n
+ * LCD_PRI_BULKのランは、優先度の高い更新を待たせないように、LCD_BULK_RUN_MAX文字で区切る。
+ */
+static bool lcd_ModelNextRun(int lane, int *pLine, int *pFrom, int *pLength)
+{
+    int maxLength = (lane == LCD_PRI_BULK) ? LCD_BULK_RUN_MAX : DDRAM_CHARS;
+    for (int k = 0; k < MAX_LINES; k++) {
+        int line = (lcdModel.nextLine + k) % MAX_LINES;
+        int to = lcdModel.aryDirtyTo[line];
+        int col = lcdModel.aryDirtyFrom[line];
+        while (col < to && !(lcd_ModelCellDirty(line, col) && (lcdModel.aryLane[line][col] & LCD_LANE_MASK) == lane)) {
+            col++;
+        }
+        if (col >= to) continue;                                // この行には、この優先度の未送信のセルは無い
+        int end = col + 1;
+        int gap = 0;
+        for (int j = col + 1; j < to && gap <= LCD_RUN_MERGE_GAP && j - col < maxLength; j++) {
+            if (lcd_ModelCellDirty(line, j) && (lcdModel.aryLane[line][j] & LCD_LANE_MASK) == lane) {
+                end = j + 1;
+                gap = 0;
+            } else {
+                gap++;
+            }
+        }
+        *pLine = line;
+        *pFrom = col;
+        *pLength = end - col;
+        return true;
+    }
+    return false;
+}
+/**
+ * @brief ランを送信するのにかかる時間を求める。
+ *
+ * @param line 行
+ * @param from 先頭カラム
+ * @param length 長さ
+ * @return uint32_t 送信にかかる時間（μ秒）
+ * @details ランのトランザクション（コントロールバイトを含む）の送信時間。右⇒左の表示モードでは、ランの前のエントリーモードの命令と、
+ * 送信後に元に戻す別のトランザクション（命令の２バイト）と、その前にランの実行を待つCMD_DELAYも含める。
+ */
+static uint32_t lcd_ModelRunUs(int line, int from, int length)
+{
+    int header = (lcdSetting.hwAddr == lcd_DDRAMAddr(line, from)) ? 1 : 3;
+    if (!lcdSetting.isDisplayToLeft) return lcd_BusTimeUs(header + length);
+    return lcd_BusTimeUs(header + 2 + length) + CMD_DELAY + lcd_BusTimeUs(2);
+}
+/**
+ * @brief ランを１回のI2Cトランザクションで送信し、送信済みとして記録する。
+ *
+ * @param line 行
+ * @param from 先頭カラム
+ * @param length 長さ
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ * @details アドレスカウンタが既にランの先頭を指している場合は、アドレス設定のコマンドを省略する。\n
+ * 右⇒左の表示モード（lcd_EntryModeSet(true)）では、書き込むたびに表示全体がシフトしてしまうので、
+ * 一時的に通常のエントリーモードにして送信し、送信後に元に戻す。
+ */
+static int lcd_ModelSendRun(int line, int from, int length)
+{
+    int iSendBytes = 0;
+    int iRet;
+    uint8_t addr = lcd_DDRAMAddr(line, from);
+    LCDBatch batch;
+    lcd_BatchInit(&batch);
+    if (lcdSetting.isDisplayToLeft) {
+        lcd_BatchCommand(&batch, LCDCommands.ENTRYMODESET | LCDCommands.EntryModeOpt.LEFT, CMD_DELAY);
+    }
+    if (lcdSetting.hwAddr != addr) {
+        lcd_BatchCommand(&batch, LCDCommands.SETDDRAMADDR | addr, CMD_DELAY);
+    }
+    // 実際に送信した内容を送信済みとして記録できるように、写しを送る
+    uint8_t aryRun[DDRAM_CHARS];
+    memcpy(aryRun, &lcdModel.aryCell[line][from], length);
+    lcd_BatchDataRun(&batch, aryRun, length);
+    iRet = lcd_BatchSend(&batch);
+    if (iRet < 0) {
+        lcdSetting.hwAddr = 0xFF;
+        return iRet;
+    }
+    iSendBytes += iRet;
+    uint32_t now = time_us_32();
+    for (int i = 0; i < length; i++) {
+        int col = from + i;
+        if (aryRun[i] != lcdModel.arySent[line][col] || (lcdModel.aryLane[line][col] & LCD_LANE_FORCE)) {
+            lcd_ModelRecordLatency(lcdModel.aryLane[line][col], lcdModel.aryStamp[line][col], now);
+        }
+        lcdModel.arySent[line][col] = aryRun[i];
+        if (lcdModel.aryCell[line][col] == aryRun[i]) {
+            lcdModel.aryLane[line][col] = 0;
+        }
+    }
+    lcdSetting.hwAddr = (from + length < DDRAM_CHARS) ? lcd_DDRAMAddr(line, from + length) : 0xFF;
+    if (lcdSetting.isDisplayToLeft) {
+        lcd_BatchInit(&batch);
+        lcd_BatchCommand(&batch, LCDCommands.ENTRYMODESET | LCDCommands.EntryModeOpt.LEFT | LCDCommands.EntryModeOpt.SHIFTINCREMENT, CMD_DELAY);
+        iRet = lcd_BatchSend(&batch);
+        if (iRet < 0) return iRet;
+        iSendBytes += iRet;
+    }
+    lcdModel.nextLine = (line + 1) % MAX_LINES;
+    return iSendBytes;
+}
+
+#if LCD_ICONEXIST
+/**
+ * @brief 指定された優先度の未送信のアイコンを、１回のトランザクションで送信する。
+ *
+ * @param lane 送信する優先度
+ * @param deadline 送信を終えなければならない時刻。この時刻までに送れる分だけを送信する。
+ * @return int 送信したバイト数。負の値の場合はエラー。その優先度のアイコンが無いか、時間が足りない場合は０。
+ * @details [拡張モード][アイコンアドレス][値]...[標準モード]を１回のトランザクションで送信する。
+ * トランザクションの最後は必ず標準モード(IS=0)に戻すので、途中で優先度の高い更新に追い越されても、命令セットの状態が崩れることは無い。\n
+ * lcd_IconSetRAW()と異なり、送信後のReturnHomeは行わない。アドレスカウンタは不明として扱い、次に文字を送信するときにアドレスを設定し直す。
+ */
+static int lcd_ModelSendIcons(int lane, uint64_t deadline)
+{
+    uint8_t aryAddr[16];
+    int count = 0;
+    for (int i = 0; i < 16; i++) {
+        if (lcd_ModelIconWanted(i) != lcdSetting.aryIconValue[i] && lcdModel.aryIconLane[i] == lane) {
+            aryAddr[count++] = i;
+        }
+    }
+    uint64_t now = time_us_64();
+    uint64_t start = (lcdSetting.busyUntil > now) ? lcdSetting.busyUntil : now;
+    // 拡張モード(2)＋アイコンごとに(4)＋標準モード(2)。バッファと時間に収まる数に減らす
+    while (count > 0 && (4 + count * 4 > LCD_BATCH_MAX || start + lcd_BusTimeUs(4 + count * 4) > deadline)) {
+        count--;
+    }
+    if (count == 0) return 0;
+    LCDBatch batch;
+    lcd_BatchInit(&batch);
+    lcd_BatchCommand(&batch, lcd_FunctionSetCmd(true), CMD_DELAY);
+    uint8_t aryValue[16];
+    for (int i = 0; i < count; i++) {
+        aryValue[i] = lcd_ModelIconWanted(aryAddr[i]);
+        lcd_BatchCommand(&batch, LCDCommands.IS1_SETICON | aryAddr[i], CMD_DELAY);
+        lcd_BatchDataByte(&batch, aryValue[i]);
+    }
+    lcd_BatchCommand(&batch, lcd_FunctionSetCmd(false), CMD_DELAY);
+    int iRet = lcd_BatchSend(&batch);
+    lcdSetting.isFunc_ISMode = false;
+    lcdSetting.hwAddr = 0xFF;                   // アドレスカウンタはアイコンのアドレスを指している
+    if (iRet < 0) return iRet;
+    uint32_t stamp = time_us_32();
+    for (int i = 0; i < count; i++) {
+        lcd_ModelRecordLatency(lane, lcdModel.aryIconStamp[aryAddr[i]], stamp);
+        lcdSetting.aryIconValue[aryAddr[i]] = aryValue[i];
+    }
+    return iRet;
+}
+#endif
+
+static void lcd_OverlayExpire(void);
+static void lcd_BlinkUpdate(void);
+
+/**
+ * @brief 表示内容のモデルのうち、未送信の部分を、指定された時間と回数の範囲内で液晶に送信する。
+ *
+ * @param budget_us 使用してよい時間（μ秒）
+ * @param maxSends 送信するラン（またはアイコンのまとまり）の最大数。lcd_FlushAsyncPoll()では、１回に１つずつ送信する。
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ */
+static int lcd_FlushRun(uint32_t budget_us, int maxSends)
+{
+    if (lcdModel.txDepth > 0) return 0;         // トランザクションの途中の内容は送信しない
+    lcd_OverlayExpire();
+    lcd_BlinkUpdate();
+    uint64_t deadline = time_us_64() + budget_us;
+    int iSendBytes = 0;
+    int iRet;
+    int lane;
+    int line, from, length;
+    int sends = 0;
+    while (sends < maxSends && (lane = lcd_ModelPendingLane()) >= 0) {
+#if LCD_ICONEXIST
+        iRet = lcd_ModelSendIcons(lane, deadline);
+        if (iRet < 0) return iRet;
+        if (iRet > 0) {
+            iSendBytes += iRet;
+            sends++;
+            continue;
+        }
+#endif
+        if (!lcd_ModelNextRun(lane, &line, &from, &length)) break;  // 時間が足りずアイコンが送れなかった
+        uint64_t now = time_us_64();
+        uint64_t start = (lcdSetting.busyUntil > now) ? lcdSetting.busyUntil : now;
+        // 予算に収まるように、ランを短くする。１文字も送れない場合はここで終わり
+        while (length > 0 && start + lcd_ModelRunUs(line, from, length) > deadline) {
+            length--;
+        }
+        if (length == 0) break;
+        iRet = lcd_ModelSendRun(line, from, length);
+        if (iRet < 0) return iRet;
+        iSendBytes += iRet;
+        sends++;
+    }
+    if (sends >= maxSends) return iSendBytes;
+    // 表示されているカーソルが、書き込んだ場所に移動してしまっているので元に戻す
+    uint8_t curAddr = lcd_DDRAMAddr(lcdSetting.curPosLine, lcdSetting.curPosColumn);
+    if (lcdSetting.isCursorDisplay && lcdSetting.hwAddr != curAddr) {
+        uint64_t now = time_us_64();
+        uint64_t start = (lcdSetting.busyUntil > now) ? lcdSetting.busyUntil : now;
+        if (start + lcd_BusTimeUs(2) <= deadline) {
+            iRet = lcd_CursorAddrSet(lcdSetting.curPosLine, lcdSetting.curPosColumn);
+            if (iRet < 0) return iRet;
+            iSendBytes += iRet;
+        }
+    }
+    return iSendBytes;
+}
+/**
+ * @brief 表示内容のモデルのうち、未送信の部分を、指定された時間の範囲内で液晶に送信する。
+ *
+ * @param budget_us この呼び出しで使用してよい時間（μ秒）。I2Cの送信時間と、液晶コントローラの実行待ち時間を含む。
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ * @details 送信を始める前に、送信にかかる時間をI2Cの速度から見積もり、予算を超える場合は送信せずに戻る。
+ * 送り切れなかった部分は、次の呼び出しで続きから送信される。\n
+ * 直前にlcd_ClearDisplay()などの実行に時間がかかる命令を送っている場合は、その実行が終わるまでの時間も予算に含めて判断する。
+ * 実行が終わるまでの時間が予算より長い場合は、待たずに０を返す。\n
+ * 最後に送信したデータの実行時間（CMD_DELAY）は、この関数から戻った後に経過するので予算には含めない。
+ * 次の呼び出しで、まだ実行中であれば予算から差し引かれる。\n
+ * トランザクションを１つ送信するたびに、未送信のもののうち最も優先度の高いものを選び直すので、
+ * 優先度の高い更新は、送信待ちの優先度の低い更新を追い越して送信される。\n
+ * カーソルを表示している場合は、送信の最後にカーソルを元の位置に戻す。
+ */
+int lcd_flush_step(uint32_t budget_us)
+{
+    lcd_AsyncStop();
+    return lcd_FlushRun(budget_us, INT_MAX);
+}
+/**
+ * @brief 表示内容のモデルのうち、指定された優先度以上の未送信の部分だけを、すべて液晶に送信する。
+ *
+ * @param minPri 送信する最低の優先度
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ * @details 表示のシフトの前に、画面に現れる部分だけを送信しておく場合などに使用する。優先度の低い部分は、モデルに残る。
+ */
+int lcd_FlushPriority(LCD_PRIORITY minPri)
+{
+    int iSendBytes = 0;
+    lcd_AsyncStop();
+    while (lcd_ModelPendingLane() >= minPri) {
+        int iRet = lcd_FlushRun(UINT32_MAX, 1);
+        if (iRet < 0) return iRet;
+        if (iRet == 0) break;
+        iSendBytes += iRet;
+    }
+    return iSendBytes;
+}
+/**
+ * @brief 表示内容のモデルのうち、未送信の部分をすべて液晶に送信する。
+ *
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ * @details 送信が終わるまで戻らない。時間を区切って少しずつ送信したい場合は、lcd_flush_step()を使用する。
+ */
+int lcd_Flush(void)
+{
+    return lcd_flush_step(UINT32_MAX);
+}
+
+/**
+ * @brief I2Cで液晶に送信した量の統計を取得する。
+ *
+ * @param pStats 統計を受け取る構造体
+ * @details lcd_init()か、lcd_BusStatsReset()を呼び出してからの累計になる。
+ */
+void lcd_BusStatsGet(LCDBusStats *pStats)
+{
+    *pStats = lcdSetting.busStats;
+}
+/**
+ * @brief I2Cで液晶に送信した量の統計をゼロにする。
+ */
+void lcd_BusStatsReset(void)
+{
+    lcdSetting.busStats.transactions = 0;
+    lcdSetting.busStats.bytes = 0;
+}
+/**
+ * @brief 液晶の操作で、CPUが動いていた時間と休んでいた時間の統計を取得する。
+ *
+ * @param pStats 統計を受け取る構造体
+ * @details lcd_init()か、lcd_CpuStatsReset()を呼び出してからの累計になる。
+ */
+void lcd_CpuStatsGet(LCDCpuStats *pStats)
+{
+    *pStats = lcdSetting.cpuStats;
+}
+/**
+ * @brief CPU時間の統計をゼロにする。
+ */
+void lcd_CpuStatsReset(void)
+{
+    memset(&lcdSetting.cpuStats, 0, sizeof(lcdSetting.cpuStats));
+}
+/**
+ * @brief アプリケーションがI2Cを使用することを、lcd_FlushAsync()に知らせる。
+ * @details 液晶と同じI2Cに接続したほかのデバイスと通信する前に呼び出す。呼び出している間は、
+ * バックグラウンドの送信はI2Cを使わずに待つ。通信が終わったらlcd_BusUnlock()を呼び出す。入れ子にしてもよい。
+ */
+void lcd_BusLock(void)
+{
+    lcdSetting.busLock++;
+}
+/**
+ * @brief lcd_BusLock()で知らせた、アプリケーションのI2Cの使用が終わったことを知らせる。
+ */
+void lcd_BusUnlock(void)
+{
+    if (lcdSetting.busLock > 0) lcdSetting.busLock--;
+}
+/**
+ * @brief 優先度ごとの、モデルに書き込まれてから送信されるまでの待ち時間の統計を取得する。
+ *
+ * @param pri 統計を取得する優先度
+ * @param pStats 統計を受け取る構造体
+ */
+void lcd_LatencyStatsGet(LCD_PRIORITY pri, LCDLatencyStats *pStats)
+{
+    *pStats = lcdModel.aryLatency[pri & LCD_LANE_MASK];
+}
+/**
+ * @brief 待ち時間の統計を、すべての優先度についてゼロにする。
+ */
+void lcd_LatencyStatsReset(void)
+{
+    memset(lcdModel.aryLatency, 0, sizeof(lcdModel.aryLatency));
+}
+
+/**
+ * @brief 液晶を書き換える最大の頻度（フレームレート）を設定する。
+ *
+ * @param maxHz １秒あたりの最大のフレーム数。０の場合は制限しない（lcd_stringなどはすぐに送信する）。
+ * @return int 常に０
+ * @details 液晶は応答に数百ミリ秒かかるので、それより速く書き換えても見た目は変わらず、I2Cの帯域とCPU時間を使うだけになる。
+ * 制限している間は、lcd_string、lcd_printf、lcd_ClearDisplay、lcd_CursorPositionなどは液晶に送信せずに表示内容のモデルに書き込み、
+ * lcd_FrameTick()を呼び出したときに、前のフレームから1/maxHz秒以上経っていれば、変更された部分をまとめて送信する。\n
+ * 制限を解除する（maxHz=0）ときは、モデルに残っている未送信の内容をすべて送信する。
+ */
+int lcd_FrameRateSet(uint32_t maxHz)
+{
+    if (maxHz == 0) {
+        lcdModel.frameIntervalUs = 0;
+        lcdModel.isFrameOpen = false;
+        lcd_Flush();
+        return 0;
+    }
+    lcdModel.frameIntervalUs = 1000000 / maxHz;
+    lcdModel.nextFrameUs = time_us_64();
+    return 0;
+}
+/**
+ * @brief フレームの時刻になっていれば、表示内容のモデルの未送信の部分を液晶に送信する。メインループなどから頻繁に呼び出す。
+ *
+ * @param budget_us この呼び出しで使用してよい時間（μ秒）。lcd_flush_step()と同じ。
+ * @return int 送信したバイト数。フレームの時刻になっていない場合は０。負の値の場合はエラー。
+ * @details フレームの時刻になっていなくても、前のフレームが送信し終わっていない場合は続きを送信する。
+ * バスが混んでいて、送信し終わる前に次のフレームの時刻になった場合は、前のフレームを待ち行列に残すのではなく、
+ * 最新の内容で置き換えて送信する（LCDFrameStats.framesDroppedに数えられる）。\n
+ * LCD_PRI_URGENTで書き込まれた内容は、フレームの時刻を待たずに送信する。
+ * フレームレートを制限していない場合は、lcd_flush_step()と同じ。
+ */
+int lcd_FrameTick(uint32_t budget_us)
+{
+    if (lcdModel.frameIntervalUs == 0) {
+        return lcd_flush_step(budget_us);
+    }
+    lcd_BlinkUpdate();                          // 点滅の切り替えも、フレームの送信に含める
+    uint64_t now = time_us_64();
+    int lane = lcd_ModelPendingLane();
+    if (lane < 0) {
+        lcdModel.isFrameOpen = false;
+        return 0;
+    }
+    if (now >= lcdModel.nextFrameUs) {
+        if (lcdModel.isFrameOpen) {
+            lcdModel.frameStats.framesDropped++;
+        }
+        lcdModel.isFrameOpen = true;
+        lcdModel.nextFrameUs = now + lcdModel.frameIntervalUs;
+    } else if (!lcdModel.isFrameOpen && lane != LCD_PRI_URGENT) {
+        return 0;
+    }
+    int iRet = lcd_flush_step(budget_us);
+    if (iRet < 0) return iRet;
+    if (lcdModel.isFrameOpen && !lcd_ModelIsDirty()) {
+        lcdModel.frameStats.framesSent++;
+        lcdModel.isFrameOpen = false;
+    }
+    return iRet;
+}
+/**
+ * @brief フレームレートの制限を使用しているときの統計を取得する。
+ *
+ * @param pStats 統計を受け取る構造体
+ */
+void lcd_FrameStatsGet(LCDFrameStats *pStats)
+{
+    *pStats = lcdModel.frameStats;
+}
+/**
+ * @brief フレームの統計をゼロにする。
+ */
+void lcd_FrameStatsReset(void)
+{
+    memset(&lcdModel.frameStats, 0, sizeof(lcdModel.frameStats));
+}
+
+/**
+ * @brief lcd_FlushAsync()のアラームの割り込みから呼び出され、次のランを送信してよいことを知らせる。
+ *
+ * @param id アラームのID
+ * @param user_data 使用しない
+ * @return int64_t 常に０（アラームは繰り返さない）
+ * @details 割り込みの中ではI2Cの送信もモデルの読み書きも行わず、フラグを立てるだけなので、数μ秒で終わる。
+ * 送信はlcd_FlushAsyncPoll()が、呼び出したスレッドの中で行う。SEVで、WFEで休んでいるコアを起こす。
+ */
+static int64_t lcd_AsyncCallback(alarm_id_t id, void *user_data)
+{
+    lcdSetting.isAsyncPending = true;
+    __sev();
+    return 0;
+}
+/**
+ * @brief lcd_FlushAsync()の次のアラームを設定する。
+ *
+ * @param at アラームの時刻（time_us_64()の値）。過ぎている場合は、すぐに送信してよいことになる。
+ * @return int ０。アラームを設定できなかった場合は-1で、バックグラウンドの送信を終了する。
+ */
+static int lcd_AsyncSchedule(uint64_t at)
+{
+    lcdSetting.asyncAlarm = add_alarm_at(from_us_since_boot(at), lcd_AsyncCallback, NULL, true);
+    if (lcdSetting.asyncAlarm < 0) {            // アラームが足りない
+        lcdSetting.isAsyncActive = false;
+        return -1;
+    }
+    // ０の場合は、時刻を過ぎていたのでこの中でコールバックが呼ばれ、isAsyncPendingが立っている
+    return 0;
+}
+/**
+ * @brief 表示内容のモデルの未送信の部分を、タイマーのアラームを使ってバックグラウンドで送信する。
+ *
+ * @param budget_us １回のlcd_FlushAsyncPoll()で使用してよい時間（μ秒）。１回では、ランを１つだけ送信する。
+ * @return int 送信を始めた場合は１、既に送信中か未送信の部分が無い場合は０、アラームを設定できなかった場合は-1。
+ * @details 液晶コントローラが実行し終わる時刻にアラームを設定して戻る。アラームはフラグを立てるだけで、
+ * 実際の送信は、メインループから呼び出すlcd_FlushAsyncPoll()で行う。液晶の実行待ちの間、CPUはほかの処理をするか、
+ * __wfe()で休むことができ、アラームの時刻になると起こされる。\n
+ * 割り込みの中では送信しないので、割り込みを止める時間はアラーム１回につき数μ秒で、送信するランの長さやI2Cの速度によらない。
+ * モデルへの書き込みと送信は同じスレッドで行われるので、送信中もlcd_ModelWrite()などで自由にモデルに書き込める。
+ * 書き込まれた内容は、同じ送信の中で送られる。\n
+ * lcd_stringなど、直接液晶に送信する関数を呼び出した場合、バックグラウンドの送信は中止され、残りは次のlcd_Flush()などで送信される。
+ * 同じI2Cに接続したほかのデバイスを使用する場合は、lcd_BusLock()/lcd_BusUnlock()で囲む。
+ * @code
+ *  lcd_FlushAsync(500);
+ *  while (true) {
+ *      control_loop();
+ *      lcd_FlushAsyncPoll();               // アラームが知らせた後だけ、ランを１つ送信する
+ *      __wfe();                            // 次の割り込み（制御のタイマーか、液晶のアラーム）まで休む
+ *  }
+ * @endcode
+ */
+int lcd_FlushAsync(uint32_t budget_us)
+{
+    if (lcdSetting.isAsyncActive) return 0;
+    lcd_BlinkUpdate();
+    if (!lcd_ModelIsDirty()) return 0;
+    lcdSetting.asyncBudgetUs = budget_us;
+    lcdSetting.isAsyncActive = true;
+    lcdSetting.isAsyncPending = false;
+    uint64_t now = time_us_64();
+    uint64_t at = (lcdSetting.busyUntil > now) ? lcdSetting.busyUntil : now;
+    if (lcd_AsyncSchedule(at) < 0) return -1;
+    return 1;
+}
+/**
+ * @brief lcd_FlushAsync()のアラームが知らせていれば、ランを１つ送信して、次のアラームを設定する。メインループから繰り返し呼び出す。
+ *
+ * @return int 送信したバイト数。アラームがまだ知らせていない場合は０。負の値の場合はエラーで、バックグラウンドの送信は終了する。
+ * @details アラームは液晶コントローラが実行し終わる時刻に設定されているので、送信の前に待つことは無い。
+ * １回の呼び出しでI2Cに使う時間は、lcd_FlushAsync()で指定したbudget_us以内（ランを予算に収まる長さに短くして送る）。\n
+ * アプリケーションがlcd_BusLock()でI2Cを使用中の場合と、lcd_begin()のトランザクションの途中の場合は、送信せずに少し後にもう一度知らせる。
+ */
+int lcd_FlushAsyncPoll(void)
+{
+    if (!lcdSetting.isAsyncActive || !lcdSetting.isAsyncPending) return 0;
+    lcdSetting.isAsyncPending = false;
+    if (lcdSetting.busLock > 0 || lcdModel.txDepth > 0) {
+        lcd_AsyncSchedule(time_us_64() + LCD_ASYNC_RETRY_US);
+        return 0;
+    }
+    lcdSetting.isInAsync = true;
+    int iRet = lcd_FlushRun(lcdSetting.asyncBudgetUs, 1);
+    lcdSetting.isInAsync = false;
+    uint64_t now = time_us_64();
+    // エラーか、送り終わったか、液晶が空いているのに予算が小さくて１文字も送れなかった場合は終了
+    if (iRet < 0 || !lcd_ModelIsDirty() || (iRet == 0 && lcdSetting.busyUntil <= now)) {
+        lcdSetting.isAsyncActive = false;
+        return iRet;
+    }
+    if (lcdSetting.busyUntil > now) {
+        lcdSetting.cpuStats.deferredUs += lcdSetting.busyUntil - now;
+    }
+    if (lcd_AsyncSchedule((lcdSetting.busyUntil > now) ? lcdSetting.busyUntil : now) < 0) return -1;
+    return iRet;
+}
+/**
+ * @brief lcd_FlushAsync()のバックグラウンドの送信が続いているかを調べる。
+ *
+ * @return bool 送信中の場合はtrue
+ */
+bool lcd_FlushAsyncBusy(void)
+{
+    return lcdSetting.isAsyncActive;
+}
+/**
+ * @brief lcd_FlushAsync()のバックグラウンドの送信を中止する。
+ * @details 直接液晶に送信する関数や、lcd_flush_step()から呼び出される。送信はlcd_FlushAsyncPoll()の中で完了しているので、
+ * アラームを取り消すだけでよい。未送信の部分はモデルに残る。lcd_FlushAsyncPoll()の送信の中から呼び出された場合は何もしない。
+ */
+void lcd_AsyncStop(void)
+{
+    if (!lcdSetting.isAsyncActive || lcdSetting.isInAsync) return;
+    cancel_alarm(lcdSetting.asyncAlarm);
+    lcdSetting.isAsyncActive = false;
+    lcdSetting.isAsyncPending = false;
+}
+
+/**
+ * @brief 画面のトランザクションを始める。lcd_commit()までの変更は、まとめて１度に送信される。
+ *
+ * @return int トランザクションの入れ子の深さ（１以上）。LCD_TX_DEPTHより深く入れ子にしようとした場合は-1。
+ * @details 値と単位のように、複数の場所を書き換える場合、１つずつ送信すると、書き換えの途中の画面が一瞬見えてしまう。
+ * トランザクションの中では、lcd_string、lcd_printf、lcd_CursorPosition、lcd_ClearDisplayなどは液晶に送信せずに
+ * 表示内容のモデルに書き込み、lcd_Flush()などもトランザクションが終わるまで送信しない。\n
+ * 右⇒左の表示モード（lcd_EntryModeSet(true)）では、lcd_stringはトランザクションの中でも直接送信される。
+ * カーソルの表示方法やコントラストなど、文字以外の設定は、トランザクションの中でもすぐに送信される。
+ */
+int lcd_begin(void)
+{
+    if (lcdModel.txDepth >= LCD_TX_DEPTH) return -1;
+    int depth = lcdModel.txDepth;
+    memcpy(lcdModel.arySnapCell[depth], lcdModel.aryBase, sizeof(lcdModel.aryBase));
+    lcdModel.arySnapLine[depth] = lcdSetting.curPosLine;
+    lcdModel.arySnapColumn[depth] = lcdSetting.curPosColumn;
+#if LCD_ICONEXIST
+    memcpy(lcdModel.arySnapIcon[depth], lcdModel.aryIconCell, sizeof(lcdModel.aryIconCell));
+#endif
+    lcdModel.txDepth++;
+    return lcdModel.txDepth;
+}
+/// @brief lcd_commit()で送信するトランザクションを組み立てるバッファ。スタックを使わないように、静的に確保する。
+static uint8_t aryCommitData[LCD_COMMIT_MAX];
+
+/**
+ * @brief lcd_commit()で送信する、行の中の次のランを探す。
+ *
+ * @param line 行
+ * @param col 探し始めるカラム
+ * @param pFrom 見つかったランの先頭カラム
+ * @param pLength 見つかったランの長さ
+ * @return bool 見つかった場合はtrue
+ * @details ランの間の送信済みのセルが１つだけの場合は、そのセルも送ってランをつなげる（[0xC0][文字]の２バイトで、アドレス設定の２バイトと同じ）。
+ */
+static bool lcd_CommitNextRun(int line, int col, int *pFrom, int *pLength)
+{
+    int to = lcdModel.aryDirtyTo[line];
+    while (col < to && !lcd_ModelCellDirty(line, col)) col++;
+    if (col >= to) return false;
+    int end = col + 1;
+    while (end < to && (lcd_ModelCellDirty(line, end) || (end + 1 < to && lcd_ModelCellDirty(line, end + 1)))) {
+        end++;
+    }
+    *pFrom = col;
+    *pLength = end - col;
+    return true;
+}
+/**
+ * @brief lcd_commit()のバッファに、コントロールバイトと１バイトを追加する。
+ *
+ * @param pLength バッファの有効なバイト数
+ * @param ctrl コントロールバイト
+ * @param val 追加するバイト
+ * @return bool 追加できた場合はtrue。バッファが一杯の場合はfalse。
+ */
+static bool lcd_CommitPut(int *pLength, uint8_t ctrl, uint8_t val)
+{
+    if (*pLength + 2 > LCD_COMMIT_MAX) return false;
+    aryCommitData[(*pLength)++] = ctrl;
+    aryCommitData[(*pLength)++] = val;
+    return true;
+}
+/**
+ * @brief 未送信のセルとアイコンを、すべて１回のI2Cトランザクションで送信する。lcd_commit()から呼び出される。
+ *
+ * @return int 送信したバイト数。未送信の部分が無い場合は０。負の値の場合はエラー。
+ * @details ランごとに[0x80][アドレス設定]に続けて、文字を[0xC0][文字]の組で並べる。Coビットが立っているので、
+ * 続けて次のランのアドレス設定を送ることができる。一番長いランだけは最後に[0x40][文字...]の連続データで送り、トランザクションを閉じる。
+ * カーソルを表示している場合と、右⇒左の表示モードの場合は、最後に命令を送る必要があるので、すべてのランを組で送る。\n
+ * 未送信のアイコンは、先頭で拡張モードに切り替えて送り、標準モードに戻す。
+ * 液晶は１つのトランザクションの中の変更を続けて実行するので、書き換えの途中の画面が見えることは無い。
+ */
+static int lcd_ModelCommitSend(void)
+{
+    lcd_OverlayExpire();
+    lcd_BlinkUpdate();
+    if (lcd_ModelPendingLane() < 0) return 0;   // 未送信の範囲もここで縮める
+    int length = 0;
+    int lastCtrl = -1;
+    bool isFit = true;
+#if LCD_ICONEXIST
+    uint8_t aryIconValue[16];
+    bool isIcon = false;
+    for (int i = 0; i < 16; i++) {
+        aryIconValue[i] = lcd_ModelIconWanted(i);
+        if (aryIconValue[i] == lcdSetting.aryIconValue[i]) continue;
+        if (!isIcon) {
+            isFit &= lcd_CommitPut(&length, LCD_CONTINUE | LCD_COMMAND, lcd_FunctionSetCmd(true));
+            isIcon = true;
+        }
+        isFit &= lcd_CommitPut(&length, LCD_CONTINUE | LCD_COMMAND, LCDCommands.IS1_SETICON | i);
+        lastCtrl = length;
+        isFit &= lcd_CommitPut(&length, LCD_CONTINUE | LCD_CHARACTER, aryIconValue[i]);
+    }
+    if (isIcon) {
+        lastCtrl = length;
+        isFit &= lcd_CommitPut(&length, LCD_CONTINUE | LCD_COMMAND, lcd_FunctionSetCmd(false));
+    }
+    uint8_t addr = isIcon ? 0xFF : lcdSetting.hwAddr;
+#else
+    uint8_t addr = lcdSetting.hwAddr;
+#endif
+    if (lcdSetting.isDisplayToLeft) {
+        lastCtrl = length;
+        isFit &= lcd_CommitPut(&length, LCD_CONTINUE | LCD_COMMAND, LCDCommands.ENTRYMODESET | LCDCommands.EntryModeOpt.LEFT);
+    }
+    // 連続データで閉じられるのは、後に命令が続かない場合だけ。閉じるランには一番長いランを選ぶ
+    uint8_t curAddr = lcd_DDRAMAddr(lcdSetting.curPosLine, lcdSetting.curPosColumn);
+    bool isClose = !lcdSetting.isDisplayToLeft && !lcdSetting.isCursorDisplay;
+    int closeLine = -1, closeFrom = 0, closeLength = 0;
+    int from, count;
+    if (isClose) {
+        for (int line = 0; line < MAX_LINES; line++) {
+            for (int col = lcdModel.aryDirtyFrom[line]; lcd_CommitNextRun(line, col, &from, &count); col = from + count) {
+                if (count > closeLength) {
+                    closeLine = line;
+                    closeFrom = from;
+                    closeLength = count;
+                }
+            }
+        }
+    }
+    for (int line = 0; line < MAX_LINES; line++) {
+        for (int col = lcdModel.aryDirtyFrom[line]; lcd_CommitNextRun(line, col, &from, &count); col = from + count) {
+            if (line == closeLine && from == closeFrom) continue;
+            if (addr != lcd_DDRAMAddr(line, from)) {
+                isFit &= lcd_CommitPut(&length, LCD_CONTINUE | LCD_COMMAND, LCDCommands.SETDDRAMADDR | lcd_DDRAMAddr(line, from));
+            }
+            for (int i = 0; i < count; i++) {
+                lastCtrl = length;
+                isFit &= lcd_CommitPut(&length, LCD_CONTINUE | LCD_CHARACTER, lcdModel.aryCell[line][from + i]);
+            }
+            addr = (from + count < DDRAM_CHARS) ? lcd_DDRAMAddr(line, from + count) : 0xFF;
+        }
+    }
+    if (closeLine >= 0) {
+        if (addr != lcd_DDRAMAddr(closeLine, closeFrom)) {
+            isFit &= lcd_CommitPut(&length, LCD_CONTINUE | LCD_COMMAND, LCDCommands.SETDDRAMADDR | lcd_DDRAMAddr(closeLine, closeFrom));
+        }
+        isFit &= (length + 1 + closeLength <= LCD_COMMIT_MAX);
+        if (isFit) {
+            lastCtrl = length;
+            aryCommitData[length++] = LCD_CHARACTER;
+            memcpy(&aryCommitData[length], &lcdModel.aryCell[closeLine][closeFrom], closeLength);
+            length += closeLength;
+        }
+        addr = (closeFrom + closeLength < DDRAM_CHARS) ? lcd_DDRAMAddr(closeLine, closeFrom + closeLength) : 0xFF;
+    }
+    if (lcdSetting.isDisplayToLeft) {
+        lastCtrl = length;
+        isFit &= lcd_CommitPut(&length, LCD_CONTINUE | LCD_COMMAND, LCDCommands.ENTRYMODESET | LCDCommands.EntryModeOpt.LEFT | LCDCommands.EntryModeOpt.SHIFTINCREMENT);
+    }
+    if (lcdSetting.isCursorDisplay && addr != curAddr) {
+        lastCtrl = length;
+        isFit &= lcd_CommitPut(&length, LCD_CONTINUE | LCD_COMMAND, LCDCommands.SETDDRAMADDR | curAddr);
+        addr = curAddr;
+    }
+    if (!isFit) return lcd_Flush();             // バッファの大きさは最大の変更が入るようにしてあるので、通常はここに来ない
+    aryCommitData[lastCtrl] &= ~LCD_CONTINUE;
+    int iRet = lcd_BusWrite(aryCommitData, length, CMD_DELAY);
+    if (iRet < 0) {
+        lcdSetting.hwAddr = 0xFF;
+        return iRet;
+    }
+    lcdSetting.hwAddr = addr;
+    uint32_t now = time_us_32();
+#if LCD_ICONEXIST
+    if (isIcon) {
+        lcdSetting.isFunc_ISMode = false;
+        for (int i = 0; i < 16; i++) {
+            if (aryIconValue[i] == lcdSetting.aryIconValue[i]) continue;
+            lcd_ModelRecordLatency(lcdModel.aryIconLane[i], lcdModel.aryIconStamp[i], now);
+            lcdSetting.aryIconValue[i] = aryIconValue[i];
+        }
+    }
+#endif
+    for (int line = 0; line < MAX_LINES; line++) {
+        for (int col = lcdModel.aryDirtyFrom[line]; col < lcdModel.aryDirtyTo[line]; col++) {
+            if (!lcd_ModelCellDirty(line, col)) continue;
+            lcd_ModelRecordLatency(lcdModel.aryLane[line][col], lcdModel.aryStamp[line][col], now);
+            lcdModel.arySent[line][col] = lcdModel.aryCell[line][col];
+            lcdModel.aryLane[line][col] = 0;
+        }
+        lcdModel.aryDirtyFrom[line] = 0;
+        lcdModel.aryDirtyTo[line] = 0;
+    }
+    return iRet;
+}
+/**
+ * @brief lcd_begin()で始めたトランザクションを終え、変更を確定する。
+ *
+ * @return int 送信したバイト数。入れ子のトランザクションの場合は、外側のトランザクションに変更を引き継ぐだけで０。
+ * トランザクションの中でない場合は-1。
+ * @details 一番外側のトランザクションを終えると、未送信のセルとアイコンのうち、送信済みの内容と異なる部分だけを、
+ * １回のI2Cトランザクションにまとめて送信する。値と単位のように離れた場所を書き換えても、途中の画面は見えない。
+ * フレームレートを制限している場合（lcd_FrameRateSet）は、送信は次のlcd_FrameTick()で行う。
+ */
+int lcd_commit(void)
+{
+    if (lcdModel.txDepth == 0) return -1;
+    lcdModel.txDepth--;
+    if (lcdModel.txDepth > 0 || lcdModel.frameIntervalUs != 0) return 0;
+    return lcd_ModelCommitSend();
+}
+/**
+ * @brief lcd_begin()で始めたトランザクションを取り消し、トランザクションの中の変更を捨てる。
+ *
+ * @return int ０。トランザクションの中でない場合は-1。
+ * @details 表示内容とカーソル位置を、lcd_begin()を呼び出したときの状態に戻す。液晶には何も送信しない。
+ * 入れ子のトランザクションの場合は、内側のトランザクションの変更だけを捨てる。
+ * 内側でlcd_commit()した変更も、外側のトランザクションを取り消すと捨てられる。
+ */
+int lcd_abort(void)
+{
+    if (lcdModel.txDepth == 0) return -1;
+    lcdModel.txDepth--;
+    int depth = lcdModel.txDepth;
+    for (int line = 0; line < MAX_LINES; line++) {
+        for (int col = 0; col < DDRAM_CHARS; col++) {
+            if (lcdModel.aryBase[line][col] != lcdModel.arySnapCell[depth][line][col]) {
+                lcd_ModelPut(line, col, lcdModel.arySnapCell[depth][line][col], LCD_PRI_NORMAL);
+                lcd_ModelMarkDirty(line, col, col + 1);
+            }
+        }
+    }
+    lcdSetting.curPosLine = lcdModel.arySnapLine[depth];
+    lcdSetting.curPosColumn = lcdModel.arySnapColumn[depth];
+#if LCD_ICONEXIST
+    memcpy(lcdModel.aryIconCell, lcdModel.arySnapIcon[depth], sizeof(lcdModel.aryIconCell));
+#endif
+    return 0;
+}
+
+/**
+ * @brief ページ切り替えモードで、裏のページ（表示していないページ）の先頭のカラムを求める。
+ *
+ * @return int 裏のページの先頭のDDRAMのカラム
+ */
+static int lcd_PageBackColumn(void)
+{
+    return (lcdModel.frontPage == 0) ? MAX_CHARS : 0;
+}
+/**
+ * @brief 指定されたページを表示するように、表示のシフト命令を１回のトランザクションで送信する。
+ *
+ * @param page 表示するページ（０か１）
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ * @details ページ１は、表示の左シフト命令MAX_CHARS個で表示する。ページ０は、シフト量に関係なくReturnHome命令１つで表示できる。
+ * フレームレートの制限やトランザクションの中でも、そのまま送信する。
+ */
+static int lcd_PageSend(int page)
+{
+    lcd_AsyncStop();
+    LCDBatch batch;
+    lcd_BatchInit(&batch);
+    if (page == 1) {
+        for (int i = 0; i < MAX_CHARS; i++) {
+            lcd_BatchCommand(&batch, LCDCommands.IS0_CURDISPSHIFT | LCDCommands.CurDispShiftOpt.DISPLAY_LEFT, CMD_DELAY);
+        }
+    } else {
+        lcd_BatchCommand(&batch, LCDCommands.RETURNHOME, CMD_DELAY_LONG);
+    }
+    int iRet = lcd_BatchSend(&batch);
+    if (iRet < 0) return iRet;
+    if (page == 1) {
+        lcdSetting.displayShift = (uint8_t)((lcdSetting.displayShift + MAX_CHARS) % DDRAM_CHARS);
+    } else {
+        lcdSetting.hwAddr = 0;
+        lcdSetting.displayShift = 0;
+    }
+    lcdModel.frontPage = page;
+    return iRet;
+}
+/**
+ * @brief ページ切り替えモードを開始/終了する。
+ *
+ * @param isOn trueで開始、falseで終了
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ * @details DDRAMは１行あたりDDRAM_CHARS(40)文字あり、画面に表示されているのはMAX_CHARS(16)文字だけなので、
+ * カラム０～15と16～31を２つのページとして使う。表示していない裏のページにlcd_PageWrite()で次の画面を書き込んでおき、
+ * lcd_PageFlip()で、表示のシフトだけで一瞬で切り替える。\n
+ * 開始すると、表示のシフトを０に戻し、カラム０～15を表示する。終了すると、表示しているページの内容をカラム０～15に写して、シフトを０に戻す。
+ */
+int lcd_PageFlipMode(bool isOn)
+{
+    int iSendBytes = 0;
+    int iRet;
+    if (!isOn && lcdModel.isPageFlip && lcdModel.frontPage == 1) {
+        for (int line = 0; line < MAX_LINES; line++) {
+            lcd_ModelWrite(line, 0, (const char *)&lcdModel.aryBase[line][MAX_CHARS], MAX_CHARS);
+        }
+        iRet = lcd_Flush();
+        if (iRet < 0) return iRet;
+        iSendBytes += iRet;
+    }
+    if (lcdSetting.displayShift != 0) {
+        iRet = lcd_PageSend(0);
+        if (iRet < 0) return iRet;
+        iSendBytes += iRet;
+    }
+    lcdModel.isPageFlip = isOn;
+    lcdModel.frontPage = 0;
+    return iSendBytes;
+}
+/**
+ * @brief ページ切り替えモードで、裏のページに文字列を書き込む。液晶にはまだ送信されない。
+ *
+ * @param line 行　（0～MAX_LINES-1）
+ * @param column ページの中のカラム（０～MAX_CHARS-1）
+ * @param s 書き込む文字列
+ * @param length 書き込む長さ。負の値の場合は文字列の長さ（NULL文字まで）。
+ * @return int 書き込んだ文字数。ページの幅を超えた部分は捨てられる。範囲外かページ切り替えモードでない場合は-1。
+ * @details 裏のページは表示されていないので、LCD_PRI_BULKの優先度で書き込む。lcd_flush_step()やlcd_FlushAsync()で、
+ * 表示している画面の更新の合間に、時間の予算の範囲で少しずつ送信される。
+ */
+int lcd_PageWrite(int line, int column, const char *s, int length)
+{
+    if (!lcdModel.isPageFlip || column < 0 || column >= MAX_CHARS) return -1;
+    if (length < 0) {
+        length = strlen(s);
+    }
+    if (length > MAX_CHARS - column) {
+        length = MAX_CHARS - column;
+    }
+    return lcd_ModelWrite(line, lcd_PageBackColumn() + column, s, length, LCD_PRI_BULK);
+}
+/**
+ * @brief ページ切り替えモードで、裏のページをすべて空白にする。液晶にはまだ送信されない。
+ *
+ * @return int ０。ページ切り替えモードでない場合は-1。
+ */
+int lcd_PageClear(void)
+{
+    if (!lcdModel.isPageFlip) return -1;
+    for (int line = 0; line < MAX_LINES; line++) {
+        lcd_ModelFill(line, lcd_PageBackColumn(), ' ', MAX_CHARS, LCD_PRI_BULK);
+    }
+    return 0;
+}
+/**
+ * @brief 裏のページが、すべて液晶に送信済みかを調べる。
+ *
+ * @return bool 送信済みで、lcd_PageFlip()ですぐに切り替えられる場合はtrue
+ */
+bool lcd_PageReady(void)
+{
+    int back = lcd_PageBackColumn();
+    for (int line = 0; line < MAX_LINES; line++) {
+        for (int col = back; col < back + MAX_CHARS; col++) {
+            if (lcd_ModelCellDirty(line, col)) return false;
+        }
+    }
+    return true;
+}
+/**
+ * @brief 表示するページを切り替える。
+ *
+ * @return int 送信したバイト数。負の値の場合はエラー。ページ切り替えモードでない場合や、トランザクションの中の場合は-1。
+ * @details 裏のページの送信が終わっていない場合は、先に残りをすべて送信する。待ちたくない場合は、lcd_PageReady()で確認してから呼び出す。\n
+ * ページ１への切り替えは、表示の左シフト命令MAX_CHARS個を、ページ０への切り替えはReturnHome命令を、１回のトランザクションで送信する。
+ * 表示のシフトが終わると、新しいページ全体が一度に表示されるので、書き換えの途中の画面は見えない。\n
+ * カーソルはシフトに追従しないので、ページ切り替えモードではカーソルを非表示にしておくこと。
+ */
+int lcd_PageFlip(void)
+{
+    int iSendBytes = 0;
+    int iRet;
+    if (!lcdModel.isPageFlip || lcdModel.txDepth > 0) return -1;
+    if (!lcd_PageReady()) {
+        iRet = lcd_Flush();
+        if (iRet < 0) return iRet;
+        iSendBytes += iRet;
+    }
+    iRet = lcd_PageSend(1 - lcdModel.frontPage);
+    if (iRet < 0) return iRet;
+    iSendBytes += iRet;
+    return iSendBytes;
+}
+
+/**
+ * @brief オーバーレイを初期化する。内容は空白になる。
+ *
+ * @param pOv 初期化するオーバーレイ
+ * @param pCells オーバーレイの内容を入れるバッファ。height×widthバイト以上必要。
+ * @param line 左上の行
+ * @param column 左上のカラム
+ * @param height 行数
+ * @param width カラム数
+ * @return int ０。画面（DDRAM）からはみ出す場合は-1。
+ */
+int lcd_OverlayInit(LCDOverlay *pOv, char *pCells, int line, int column, int height, int width)
+{
+    if (pCells == NULL || line < 0 || column < 0 || height <= 0 || width <= 0) return -1;
+    if (line + height > MAX_LINES || column + width > DDRAM_CHARS) return -1;
+    memset(pCells, ' ', height * width);
+    pOv->pCells = pCells;
+    pOv->line = line;
+    pOv->column = column;
+    pOv->height = height;
+    pOv->width = width;
+    pOv->isShown = false;
+    pOv->hideAt = 0;
+    return 0;
+}
+/**
+ * @brief オーバーレイに文字列を書き込む。表示中の場合は、表示内容のモデルにも反映する。
+ *
+ * @param pOv オーバーレイ
+ * @param line オーバーレイの中の行
+ * @param column オーバーレイの中のカラム
+ * @param s 書き込む文字列
+ * @param length 書き込む長さ。負の値の場合は文字列の長さ（NULL文字まで）。
+ * @return int 書き込んだ文字数。オーバーレイの幅を超えた部分は捨てられる。範囲外の場合は-1。
+ */
+int lcd_OverlayWrite(LCDOverlay *pOv, int line, int column, const char *s, int length)
+{
+    if (line < 0 || line >= pOv->height || column < 0 || column >= pOv->width) return -1;
+    if (length < 0) {
+        length = strlen(s);
+    }
+    if (length > pOv->width - column) {
+        length = pOv->width - column;
+    }
+    memcpy(&pOv->pCells[line * pOv->width + column], s, length);
+    if (pOv->isShown) {
+        lcd_ModelOverlayComposite(pOv, LCD_PRI_NORMAL);
+    }
+    return length;
+}
+/**
+ * @brief オーバーレイを、一番上に重ねて表示する。液晶にはまだ送信されない。
+ *
+ * @param pOv オーバーレイ
+ * @param durationMs 表示する時間（ミリ秒）。時間が過ぎると、次のlcd_flush_step()などで自動的に消える。０の場合は、lcd_OverlayHide()を呼ぶまで表示する。
+ * @return int ０。重ねられるオーバーレイの数(LCD_OVERLAY_MAX)を超える場合は-1。
+ * @details 既に表示中のオーバーレイの場合は、一番上に移動する。重ね合わせた結果が変わったセルだけが、優先度LCD_PRI_URGENTで送信される。
+ */
+int lcd_OverlayShow(LCDOverlay *pOv, uint32_t durationMs)
+{
+    int i;
+    for (i = 0; i < lcdModel.overlayCount && lcdModel.aryOverlay[i] != pOv; i++) {}
+    if (i == lcdModel.overlayCount) {
+        if (lcdModel.overlayCount >= LCD_OVERLAY_MAX) return -1;
+        lcdModel.overlayCount++;
+    }
+    for (; i < lcdModel.overlayCount - 1; i++) {
+        lcdModel.aryOverlay[i] = lcdModel.aryOverlay[i + 1];
+    }
+    lcdModel.aryOverlay[lcdModel.overlayCount - 1] = pOv;
+    pOv->isShown = true;
+    pOv->hideAt = (durationMs == 0) ? 0 : time_us_64() + (uint64_t)durationMs * 1000;
+    lcd_ModelOverlayComposite(pOv, LCD_PRI_URGENT);
+    return 0;
+}
+/**
+ * @brief オーバーレイを消し、下にあった内容を表示内容のモデルから元に戻す。液晶にはまだ送信されない。
+ *
+ * @param pOv オーバーレイ
+ * @return int ０。表示していないオーバーレイの場合は-1。
+ * @details 下の内容はモデルに残っているので、アプリケーションが描き直す必要はない。オーバーレイの表示中に下の内容が変わっていれば、
+ * 変わった後の内容が表示される。重ね合わせた結果が変わったセルだけが送信される。
+ */
+int lcd_OverlayHide(LCDOverlay *pOv)
+{
+    int i;
+    for (i = 0; i < lcdModel.overlayCount && lcdModel.aryOverlay[i] != pOv; i++) {}
+    if (i == lcdModel.overlayCount) return -1;
+    for (; i < lcdModel.overlayCount - 1; i++) {
+        lcdModel.aryOverlay[i] = lcdModel.aryOverlay[i + 1];
+    }
+    lcdModel.overlayCount--;
+    pOv->isShown = false;
+    pOv->hideAt = 0;
+    lcd_ModelOverlayComposite(pOv, LCD_PRI_URGENT);
+    return 0;
+}
+/**
+ * @brief 表示時間が過ぎたオーバーレイを消す。送信の前に呼び出される。
+ */
+static void lcd_OverlayExpire(void)
+{
+    uint64_t now = time_us_64();
+    for (int i = lcdModel.overlayCount - 1; i >= 0; i--) {
+        LCDOverlay *pOv = lcdModel.aryOverlay[i];
+        if (pOv->hideAt != 0 && now >= pOv->hideAt) {
+            lcd_OverlayHide(pOv);
+        }
+    }
+}
+
+/**
+ * @brief 点滅の周期を設定する。
+ *
+ * @param periodMs 周期（ミリ秒）。半分の時間ずつ表示と消去を繰り返す。０の場合はLCD_BLINK_PERIOD_MS。
+ * @return int 常に０
+ * @details 点滅するセルとアイコンは、すべてこの周期で同時に切り替わる。
+ */
+int lcd_BlinkPeriodSet(uint32_t periodMs)
+{
+    lcdModel.blinkPeriodUs = periodMs * 1000;
+    return 0;
+}
+/**
+ * @brief 表示内容のモデルの範囲に、点滅の属性を設定/解除する。液晶にはまだ送信されない。
+ *
+ * @param line 行　（0～MAX_LINES-1）
+ * @param column 先頭のカラム（０～DDRAM_CHARS-1）
+ * @param length 範囲の長さ。DDRAM_CHARSを超えた部分は捨てられる。
+ * @param isBlink trueの場合は点滅させる。falseの場合は点滅をやめ、常に表示する。
+ * @return int 属性を変えたセルの数。行やカラムが範囲外の場合は-1。
+ * @details 点滅は属性なので、アラームの値などをlcd_ModelWrite()で書き換えても、そのまま点滅し続ける。
+ * 消えている側の半周期では、セルを空白として送信する。オーバーレイに覆われているセルは点滅しない。
+
+ * 液晶のブリンク（lcd_CursorMode）はカーソルの１文字しか点滅できないので、表示内容のモデルで点滅させる。
+ * 切り替えは、lcd_flush_step()、lcd_FrameTick()、lcd_FlushAsync()の呼び出しで行われ、同じ時刻に切り替わるセルとアイコンは、
+ * すべて同じ送信にまとめられる。点滅させている間は、これらを周期より短い間隔で呼び出す。
+ */
+int lcd_BlinkSet(int line, int column, int length, bool isBlink)
+{
+    if (line < 0 || line >= MAX_LINES || column < 0 || column >= DDRAM_CHARS || length < 0) return -1;
+    if (length > DDRAM_CHARS - column) {
+        length = DDRAM_CHARS - column;
+    }
+    for (int col = column; col < column + length; col++) {
+        if (isBlink) {
+            lcdModel.aryBlinkMask[line] |= (uint64_t)1 << col;
+        } else {
+            lcdModel.aryBlinkMask[line] &= ~((uint64_t)1 << col);
+        }
+        lcd_ModelSetCell(line, col, lcd_ModelComposite(line, col), LCD_PRI_NORMAL);
+    }
+    if (length > 0) {
+        lcd_ModelMarkDirty(line, column, column + length);
+    }
+    return length;
+}
+#if LCD_ICONEXIST
+/**
+ * @brief アイコンに、点滅の属性を設定/解除する。液晶にはまだ送信されない。
+ *
+ * @param icon 点滅させるアイコン。
+ * @param isBlink trueの場合は点滅させる。falseの場合は点滅をやめる。
+ * @return int 常に０
+ * @details 点滅させるのは、lcd_ModelIconSet()で表示しているときだけ。消しているアイコンは、点滅の属性があっても消えたまま。
+ * 切り替えでは、点滅で値が変わったアイコンのアドレスだけを１回のトランザクションで送信し、lcd_IconSet()と異なりReturnHomeは送信しない。\n
+ * 消えている側の半周期に、同じアドレスの別のアイコンをlcd_IconSet()で変えても、点滅しているアイコンはモデルに残り、次の半周期で再び表示される。
+ */
+int lcd_BlinkIconSet(LCD_ICON icon, bool isBlink)
+{
+    uint8_t iconAddr = (uint8_t)((icon >> 8) & 0x0F);
+    uint8_t iconBits = (uint8_t)(icon & 0xFF);
+    bool wasDirty = lcd_ModelIconWanted(iconAddr) != lcdSetting.aryIconValue[iconAddr];
+    if (isBlink) {
+        lcdModel.aryIconBlink[iconAddr] |= iconBits;
+    } else {
+        lcdModel.aryIconBlink[iconAddr] &= ~iconBits;
+    }
+    lcd_ModelIconTouch(iconAddr, wasDirty, LCD_PRI_NORMAL);
+    return 0;
+}
+#endif
+/**
+ * @brief 点滅の半周期が変わっていれば、点滅するセルとアイコンを切り替える。送信の前に呼び出される。
+ * @details 半周期は起動からの時刻で決めるので、点滅するものはすべて同じ時刻に切り替わる。
+ * 切り替えたセルとアイコンは、優先度LCD_PRI_NORMALで未送信になり、続く送信でまとめて送られる。
+ */
+static void lcd_BlinkUpdate(void)
+{
+    bool isAny = false;
+    for (int line = 0; line < MAX_LINES; line++) {
+        if (lcdModel.aryBlinkMask[line] != 0) isAny = true;
+    }
+#if LCD_ICONEXIST
+    bool aryWasDirty[16];
+    for (int i = 0; i < 16; i++) {
+        if (lcdModel.aryIconBlink[i] != 0) isAny = true;
+        aryWasDirty[i] = lcd_ModelIconWanted(i) != lcdSetting.aryIconValue[i];
+    }
+#endif
+    uint32_t periodUs = (lcdModel.blinkPeriodUs != 0) ? lcdModel.blinkPeriodUs : LCD_BLINK_PERIOD_MS * 1000;
+    bool isOff = isAny && ((time_us_64() / (periodUs / 2)) & 1);
+    if (isOff == lcdModel.isBlinkOff) return;
+    lcdModel.isBlinkOff = isOff;
+    for (int line = 0; line < MAX_LINES; line++) {
+        uint64_t mask = lcdModel.aryBlinkMask[line];
+        if (mask == 0) continue;
+        int from = DDRAM_CHARS;
+        int to = 0;
+        for (int col = 0; col < DDRAM_CHARS; col++) {
+            if (!(mask & ((uint64_t)1 << col))) continue;
+            lcd_ModelSetCell(line, col, lcd_ModelComposite(line, col), LCD_PRI_NORMAL);
+            if (col < from) from = col;
+            to = col + 1;
+        }
+        lcd_ModelMarkDirty(line, from, to);
+    }
+#if LCD_ICONEXIST
+    for (int i = 0; i < 16; i++) {
+        if (lcdModel.aryIconBlink[i] != 0) {
+            lcd_ModelIconTouch(i, aryWasDirty[i], LCD_PRI_NORMAL);
+        }
+    }
+#endif
+}
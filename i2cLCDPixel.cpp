@@ -0,0 +1,265 @@
+/**
+ * @file i2cLCDPixel.cpp
+ * @author Hisayuki Nomura
+ * @brief 外字（CGRAM）の８文字を並べて、小さなビットマップとして点や線を描くための処理。\n
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details 外字の８文字を横cols文字×縦rows行に並べて画面に置き、(cols×5)×(rows×8)ドットのキャンバスとして使う。
+ * メーターやアイコン、小さなグラフを描ける。\n
+ * 描画はCGRAMと同じ形の64バイトのバッファに対して行い、変わったCGRAMの行（外字の１ドット行）にだけ印を付ける。
+ * lcd_PixelFlush()は、印の付いた行だけを１回のトランザクションで送信する。外字１文字ごとにlcd_CGRAMSet()を呼ぶと、
+ * １バイトごとにトランザクションが分かれるので、それより大幅に少ない送信になる。
+ *
+ * @code
+ *  lcd_PixelInit(0, 12, 4, 2);             // 画面の右上に20×16ドット
+ *  lcd_Flush();
+ *  while (true) {
+ *      lcd_PixelClear();
+ *      lcd_PixelLine(10, 15, 10 + dx, 15 - dy, true);
+ *      lcd_PixelFlush();
+ *  }
+ * @endcode
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "i2cLCD.h"
+#include "i2cLCDlocal.h"
+#include "i2cLCDPixel.h"
+
+/// @brief キャンバスの横の文字数
+static uint8_t pixelCols = 0;
+/// @brief キャンバスの縦の行数
+static uint8_t pixelRows = 0;
+/// @brief CGRAMと同じ形のビットマップ。[文字コード×8＋ドット行]の下位５ビットが、左から右のドット。
+static uint8_t aryPixelRow[64];
+/// @brief 液晶に送っていないCGRAMの行（ビットの位置がaryPixelRowの添え字）
+static uint64_t pixelDirty = 0;
+
+/**
+ * @brief キャンバスを初期化し、外字を画面に並べる。
+ *
+ * @param line 画面に置く先頭の行
+ * @param column 画面に置く先頭のカラム（DDRAMのカラム）
+ * @param cols 横の文字数
+ * @param rows 縦の行数。cols×rowsは８以下。
+ * @return int ０。範囲外の場合は-1。
+ * @details 外字の文字コード０から順に、左上から右、下の行へと表示内容のモデルに書き込む。液晶への送信はlcd_Flush()などで行う。
+ * キャンバスはすべて消去した状態になり、次のlcd_PixelFlush()で使用するCGRAMの全体を送信する。
+ */
+int lcd_PixelInit(int line, int column, int cols, int rows)
+{
+    if (cols < 1 || rows < 1 || cols * rows > 8) return -1;
+    if (line < 0 || line + rows > MAX_LINES || column < 0 || column + cols > DDRAM_CHARS) return -1;
+    pixelCols = cols;
+    pixelRows = rows;
+    memset(aryPixelRow, 0, sizeof(aryPixelRow));
+    pixelDirty = (cols * rows == 8) ? ~(uint64_t)0 : (((uint64_t)1 << (cols * rows * 8)) - 1);
+    for (int r = 0; r < rows; r++) {
+        char aryCode[8];
+        for (int c = 0; c < cols; c++) {
+            aryCode[c] = (char)(r * cols + c);
+        }
+        lcd_ModelWrite(line + r, column, aryCode, cols);
+    }
+    return 0;
+}
+/**
+ * @brief キャンバスをすべて消去する。
+ *
+ * @return int 常に０
+ */
+int lcd_PixelClear(void)
+{
+    for (int i = 0; i < pixelCols * pixelRows * 8; i++) {
+        if (aryPixelRow[i] != 0) {
+            aryPixelRow[i] = 0;
+            pixelDirty |= (uint64_t)1 << i;
+        }
+    }
+    return 0;
+}
+/**
+ * @brief 点を描く/消す。
+ *
+ * @param x 横の位置（０～cols×5-1）
+ * @param y 縦の位置（０～rows×8-1）
+ * @param isOn trueの場合は点灯、falseの場合は消灯
+ * @return int ０。キャンバスの外の場合は-1（何もしない）。
+ */
+int lcd_PixelSet(int x, int y, bool isOn)
+{
+    if (x < 0 || x >= pixelCols * 5 || y < 0 || y >= pixelRows * 8) return -1;
+    int index = ((y / 8) * pixelCols + x / 5) * 8 + y % 8;
+    uint8_t bit = 0x10 >> (x % 5);
+    uint8_t value = isOn ? (aryPixelRow[index] | bit) : (aryPixelRow[index] & ~bit);
+    if (value != aryPixelRow[index]) {
+        aryPixelRow[index] = value;
+        pixelDirty |= (uint64_t)1 << index;
+    }
+    return 0;
+}
+/**
+ * @brief 点の状態を取得する。
+ *
+ * @param x 横の位置
+ * @param y 縦の位置
+ * @return bool 点灯している場合はtrue。キャンバスの外の場合はfalse。
+ */
+bool lcd_PixelGet(int x, int y)
+{
+    if (x < 0 || x >= pixelCols * 5 || y < 0 || y >= pixelRows * 8) return false;
+    int index = ((y / 8) * pixelCols + x / 5) * 8 + y % 8;
+    return (aryPixelRow[index] & (0x10 >> (x % 5))) != 0;
+}
+/**
+ * @brief 直線を描く/消す。キャンバスの外にはみ出した部分は描かない。
+ *
+ * @param x0 始点の横の位置
+ * @param y0 始点の縦の位置
+ * @param x1 終点の横の位置
+ * @param y1 終点の縦の位置
+ * @param isOn trueの場合は点灯、falseの場合は消灯
+ * @return int 常に０
+ */
+int lcd_PixelLine(int x0, int y0, int x1, int y1, bool isOn)
+{
+    int dx = abs(x1 - x0);
+    int dy = -abs(y1 - y0);
+    int sx = (x0 < x1) ? 1 : -1;
+    int sy = (y0 < y1) ? 1 : -1;
+    int err = dx + dy;
+    while (true) {
+        lcd_PixelSet(x0, y0, isOn);
+        if (x0 == x1 && y0 == y1) break;
+        int e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+    return 0;
+}
+/**
+ * @brief 長方形を描く/消す。
+ *
+ * @param x 左上の横の位置
+ * @param y 左上の縦の位置
+ * @param width 幅（ドット数）
+ * @param height 高さ（ドット数）
+ * @param isOn trueの場合は点灯、falseの場合は消灯
+ * @param isFill trueの場合は内側も塗りつぶす。falseの場合は枠だけ。
+ * @return int 常に０
+ */
+int lcd_PixelRect(int x, int y, int width, int height, bool isOn, bool isFill)
+{
+    for (int py = y; py < y + height; py++) {
+        for (int px = x; px < x + width; px++) {
+            if (isFill || py == y || py == y + height - 1 || px == x || px == x + width - 1) {
+                lcd_PixelSet(px, py, isOn);
+            }
+        }
+    }
+    return 0;
+}
+/**
+ * @brief ビットマップを、キャンバスに写す。
+ *
+ * @param x 写す先の左上の横の位置
+ * @param y 写す先の左上の縦の位置
+ * @param pBitmap ビットマップ。１行を(width+7)/8バイトとし、各バイトの上位ビットが左のドット。
+ * @param width 幅（ドット数）
+ * @param height 高さ（ドット数）
+ * @return int 常に０
+ * @details ビットマップの０のドットは消灯する。キャンバスの外にはみ出した部分は写さない。
+ */
+int lcd_PixelBlit(int x, int y, const uint8_t *pBitmap, int width, int height)
+{
+    int stride = (width + 7) / 8;
+    for (int py = 0; py < height; py++) {
+        for (int px = 0; px < width; px++) {
+            bool isOn = (pBitmap[py * stride + px / 8] & (0x80 >> (px % 8))) != 0;
+            lcd_PixelSet(x + px, y + py, isOn);
+        }
+    }
+    return 0;
+}
+/**
+ * @brief 変わったCGRAMの行だけを、１回のトランザクションで液晶に送信する。
+ *
+ * @return int i2cで送信したバイト数。変わった行が無い場合は０。負の値の場合はエラー。
+ * @details 変わった行を、LCD_PIXEL_MERGE_GAP以下の隙間をはさんでランにまとめる。送信の方法は、次の２つのうち短い方を選ぶ。
+ * - 最初の変わった行から最後の変わった行までを、１つのSETCGRAMに続くデータとして送る（3＋行数バイト）
+ * - ランごとにSETCGRAMを送り、データはCoビットを立てて１バイトずつ続ける（最後のランだけは続けて送る）
+ */
+int lcd_PixelFlush(void)
+{
+    if (pixelDirty == 0) return 0;
+    uint8_t aryFrom[32];
+    uint8_t aryLength[32];
+    int runs = 0;
+    for (int i = 0; i < 64; i++) {
+        if (!(pixelDirty & ((uint64_t)1 << i))) continue;
+        if (runs > 0 && i - (aryFrom[runs - 1] + aryLength[runs - 1]) <= LCD_PIXEL_MERGE_GAP) {
+            aryLength[runs - 1] = i - aryFrom[runs - 1] + 1;
+        } else {
+            aryFrom[runs] = i;
+            aryLength[runs] = 1;
+            runs++;
+        }
+    }
+    int first = aryFrom[0];
+    int end = aryFrom[runs - 1] + aryLength[runs - 1];
+    int spanBytes = 3 + (end - first);
+    int runBytes = 3 + aryLength[runs - 1];
+    for (int r = 0; r < runs - 1; r++) {
+        runBytes += 2 + aryLength[r] * 2;
+    }
+    uint8_t t_data[3 + 64];
+    int length = 0;
+    if (runBytes < spanBytes) {
+        for (int r = 0; r < runs; r++) {
+            t_data[length++] = LCD_CONTINUE | LCD_COMMAND;
+            t_data[length++] = LCDCommands.IS0_SETCGRAM | aryFrom[r];
+            if (r == runs - 1) {
+                t_data[length++] = LCD_CHARACTER;
+                memcpy(&t_data[length], &aryPixelRow[aryFrom[r]], aryLength[r]);
+                length += aryLength[r];
+            } else {
+                for (int i = 0; i < aryLength[r]; i++) {
+                    t_data[length++] = LCD_CONTINUE | LCD_CHARACTER;
+                    t_data[length++] = aryPixelRow[aryFrom[r] + i];
+                }
+            }
+        }
+    } else {
+        t_data[length++] = LCD_CONTINUE | LCD_COMMAND;
+        t_data[length++] = LCDCommands.IS0_SETCGRAM | first;
+        t_data[length++] = LCD_CHARACTER;
+        memcpy(&t_data[length], &aryPixelRow[first], end - first);
+        length += end - first;
+    }
+    int iSendBytes = lcd_BusWrite(t_data, length, CMD_DELAY);
+    lcdSetting.hwAddr = 0xFF;                       // アドレスカウンタはCGRAMを指している
+    lcdSetting.cgramOwner = LCD_CGRAM_OWNER_NONE;
+    if (iSendBytes < 0) return iSendBytes;
+    pixelDirty = 0;
+    // 表示されているカーソルが、CGRAMのアドレスに移動してしまっているので元に戻す
+    if (lcdSetting.isCursorDisplay) {
+        int iRet = lcd_CursorAddrSet(lcdSetting.curPosLine, lcdSetting.curPosColumn);
+        if (iRet < 0) return iRet;
+        iSendBytes += iRet;
+    }
+    return iSendBytes;
+}
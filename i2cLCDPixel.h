@@ -0,0 +1,36 @@
+/**
+ * @file i2cLCDPixel.h
+ * @author Hisayuki Nomura
+ * @brief 外字（CGRAM）の８文字を並べて、小さなビットマップとして点や線を描くためのヘッダファイル。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details ピクセルキャンバスを使用するプログラムは、i2cLCD.hに続けてこのヘッダファイルをincludeする。\n
+ * 外字は８文字しかないので、キャンバスは１つだけ。例えば横４文字×縦２行に並べると、20×16ドットになる。
+ * @code
+ *  lcd_PixelInit(0, 12, 4, 2);
+ *  lcd_PixelLine(0, 15, 19, 0, true);
+ *  lcd_PixelFlush();
+ * @endcode
+ */
+#ifndef __i2cLCDPixel_h__
+#define __i2cLCDPixel_h__
+
+#include "i2cLCD.h"
+
+/// @brief 離れた変更行を、１回のSETCGRAMで続けて送るときに、間に挟んで送ってしまう変わっていない行の最大の数
+#define LCD_PIXEL_MERGE_GAP     2
+
+int lcd_PixelInit(int line, int column, int cols, int rows);
+int lcd_PixelClear(void);
+int lcd_PixelSet(int x, int y, bool isOn);
+bool lcd_PixelGet(int x, int y);
+int lcd_PixelLine(int x0, int y0, int x1, int y1, bool isOn);
+int lcd_PixelRect(int x, int y, int width, int height, bool isOn, bool isFill);
+int lcd_PixelBlit(int x, int y, const uint8_t *pBitmap, int width, int height);
+int lcd_PixelFlush(void);
+
+#endif
@@ -0,0 +1,179 @@
+/**
+ * @file i2cLCDRemote.cpp
+ * @author Hisayuki Nomura
+ * @brief PCから差分の通信プロトコル（i2cLCDRemoteProto.h）で送られた表示を、液晶に表示するための処理。\n
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details USB CDCやUARTで受信したバイト列をlcd_RemoteFeed()に渡すと、フレームを取り出して表示内容のモデルに反映する。
+ * PCは変わったセルのランだけを送るので、画面全体（32文字）を毎回送るより、通信量が少ない。
+ * 液晶への送信は、ほかの表示と同じくlcd_flush_step()などで行う。\n
+ * フレームの番号が抜けていた場合は、以降のフレームを捨て、lcd_RemoteInit()で指定した関数でLCD_REMOTE_NAKをPCに返す。
+ * PCはLCD_REMOTE_RESETに続けて画面全体を送り直す。
+ *
+ * @code
+ *  static void sendToHost(const uint8_t *buf, int length) { uart_write_blocking(uart0, buf, length); }
+ *  lcd_RemoteInit(sendToHost);
+ *  while (true) {
+ *      uint8_t aryBuf[64];
+ *      int n = 0;
+ *      while (n < (int)sizeof(aryBuf) && uart_is_readable(uart0)) aryBuf[n++] = uart_getc(uart0);
+ *      lcd_RemoteFeed(aryBuf, n);
+ *      lcd_flush_step(500);
+ *  }
+ * @endcode
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "i2cLCD.h"
+#include "i2cLCDlocal.h"
+#include "i2cLCDRemote.h"
+
+/// @brief 同期が外れている間、LCD_REMOTE_NAKを送り直すまでに捨てるフレームの数
+#define LCD_REMOTE_NAK_INTERVAL 8
+
+/// @brief 受信したバイト列からフレームを取り出す状態
+static LCDRemoteParser lcdRemoteParser;
+/// @brief PCにフレームを送る関数
+static void (*pRemoteSend)(const uint8_t *buf, int length) = NULL;
+/// @brief 次に期待するフレームの番号
+static uint8_t remoteExpectSeq = 0;
+/// @brief PCと番号が揃っている場合はtrue。LCD_REMOTE_RESETを受け取るまではfalse。
+static bool isRemoteSynced = false;
+/// @brief 同期が外れてから捨てたフレームの数
+static uint32_t remoteDropped = 0;
+/// @brief 最後に設定したカーソルのフラグ。0xFFの場合はまだ設定していない。
+static uint8_t remoteCursorFlags = 0xFF;
+/// @brief 統計
+static LCDRemoteStats lcdRemoteStats;
+
+/**
+ * @brief リモート表示を初期化する。
+ *
+ * @param pSend PCにフレームを送る関数。NULLの場合は、再送の要求を送らない。
+ * @return int 常に０
+ * @details PCからLCD_REMOTE_RESETを受け取るまでは、表示のフレームを捨てる。
+ */
+int lcd_RemoteInit(void (*pSend)(const uint8_t *buf, int length))
+{
+    lcd_RemoteParserInit(&lcdRemoteParser);
+    pRemoteSend = pSend;
+    isRemoteSynced = false;
+    remoteDropped = 0;
+    remoteCursorFlags = 0xFF;
+    memset(&lcdRemoteStats, 0, sizeof(lcdRemoteStats));
+    return 0;
+}
+/**
+ * @brief PCに、画面全体の再送を求める。
+ */
+static void lcd_RemoteSendNak(void)
+{
+    if (pRemoteSend == NULL) return;
+    uint8_t aryFrame[LCD_REMOTE_FRAME_MAX];
+    int length = lcd_RemoteEncode(aryFrame, 0, LCD_REMOTE_NAK, &remoteExpectSeq, 1);
+    pRemoteSend(aryFrame, length);
+}
+/**
+ * @brief フレームの内容を、表示内容のモデルに反映する。
+ *
+ * @param type 種類
+ * @param pPayload payload
+ * @param length payloadの長さ
+ * @details 範囲外の値を含むフレームは無視する。
+ */
+static void lcd_RemoteApply(uint8_t type, const uint8_t *pPayload, int length)
+{
+    switch (type) {
+    case LCD_REMOTE_CELLS:
+        if (length < 2 || pPayload[0] >= MAX_LINES || pPayload[1] + (length - 2) > DDRAM_CHARS) return;
+        lcd_ModelWrite(pPayload[0], pPayload[1], (const char *)&pPayload[2], length - 2);
+        break;
+#if LCD_ICONEXIST
+    case LCD_REMOTE_ICONS:
+        for (int i = 0; i + 1 < length; i += 2) {
+            uint8_t iconAddr = pPayload[i] & 0x0F;
+            for (int bit = 0; bit < 5; bit++) {
+                LCD_ICON icon = (LCD_ICON)((iconAddr << 8) | (1 << bit));
+                lcd_ModelIconSet((pPayload[i + 1] & (1 << bit)) != 0, icon);
+            }
+        }
+        break;
+#endif
+    case LCD_REMOTE_GLYPH:
+        if (length != 9 || pPayload[0] >= 8) return;
+        lcd_CGRAMWrite(pPayload[0] * 8, &pPayload[1], 8);
+        break;
+    case LCD_REMOTE_CURSOR:
+        if (length != 3 || pPayload[0] >= MAX_LINES || pPayload[1] >= DDRAM_CHARS) return;
+        if (pPayload[2] != remoteCursorFlags) {
+            remoteCursorFlags = pPayload[2];
+            lcd_CursorMode(true, (pPayload[2] & LCD_REMOTE_CURSOR_UNDERLINE) != 0, (pPayload[2] & LCD_REMOTE_CURSOR_BLINK) != 0);
+            if (!(pPayload[2] & LCD_REMOTE_CURSOR_VISIBLE)) {
+                lcd_CursorDisplay(false);
+            }
+        }
+        lcd_CursorPosition(pPayload[0], pPayload[1]);
+        break;
+    default:
+        break;
+    }
+}
+/**
+ * @brief 受信したバイト列を渡し、含まれているフレームを表示内容のモデルに反映する。
+ *
+ * @param buf 受信したバイト列。フレームの途中で分かれていてもよい。
+ * @param length 長さ
+ * @return int 表示に反映したフレームの数
+ * @details 液晶への送信は、lcd_flush_step()などで行う。外字（LCD_REMOTE_GLYPH）とカーソルは、すぐに液晶に送信する。
+ * 外字は、lcd_CGRAMWrite()で１文字（８バイト）を１回のトランザクションで送信する。
+ */
+int lcd_RemoteFeed(const uint8_t *buf, int length)
+{
+    int count = 0;
+    for (int i = 0; i < length; i++) {
+        if (!lcd_RemoteParse(&lcdRemoteParser, buf[i])) continue;
+        uint8_t seq = lcdRemoteParser.aryFrame[0];
+        uint8_t type = lcdRemoteParser.aryFrame[1];
+        if (type == LCD_REMOTE_RESET) {
+            isRemoteSynced = true;
+            remoteExpectSeq = seq + 1;
+            lcdRemoteStats.resyncs++;
+            continue;
+        }
+        if (!isRemoteSynced || seq != remoteExpectSeq) {
+            // 番号が抜けた後のフレームは、差分の前提が崩れているので捨てる
+            if (isRemoteSynced) {
+                lcdRemoteStats.seqGaps++;
+                isRemoteSynced = false;
+                remoteDropped = 0;
+            }
+            if (remoteDropped % LCD_REMOTE_NAK_INTERVAL == 0) lcd_RemoteSendNak();
+            remoteDropped++;
+            continue;
+        }
+        remoteExpectSeq++;
+        remoteDropped = 0;
+        lcd_RemoteApply(type, &lcdRemoteParser.aryFrame[3], lcdRemoteParser.aryFrame[2]);
+        lcdRemoteStats.frames++;
+        count++;
+    }
+    lcdRemoteStats.crcErrors = lcdRemoteParser.crcErrors;
+    return count;
+}
+/**
+ * @brief リモート表示の統計を取得する。
+ *
+ * @param pStats 統計を入れる構造体
+ */
+void lcd_RemoteStatsGet(LCDRemoteStats *pStats)
+{
+    *pStats = lcdRemoteStats;
+}
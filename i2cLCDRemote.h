@@ -0,0 +1,38 @@
+/**
+ * @file i2cLCDRemote.h
+ * @author Hisayuki Nomura
+ * @brief PCから差分の通信プロトコル（i2cLCDRemoteProto.h）で送られた表示を、液晶に表示するためのヘッダファイル。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details リモート表示を使用するプログラムは、i2cLCD.hに続けてこのヘッダファイルをincludeする。
+ * PC側のライブラリは、host/ディレクトリにある。
+ */
+#ifndef __i2cLCDRemote_h__
+#define __i2cLCDRemote_h__
+
+#include "i2cLCD.h"
+#include "i2cLCDRemoteProto.h"
+
+/**
+ * @brief リモート表示の統計。lcd_RemoteStatsGet()で取得する。
+ */
+struct LCDRemoteStats {
+    /// @brief 表示に反映したフレームの数
+    uint32_t frames;
+    /// @brief 長さやCRCが正しくなかったフレームの数
+    uint32_t crcErrors;
+    /// @brief 番号の抜けを見つけた回数（LCD_REMOTE_NAKを送った回数）
+    uint32_t seqGaps;
+    /// @brief LCD_REMOTE_RESETを受け取った回数
+    uint32_t resyncs;
+};
+
+int lcd_RemoteInit(void (*pSend)(const uint8_t *buf, int length));
+int lcd_RemoteFeed(const uint8_t *buf, int length);
+void lcd_RemoteStatsGet(LCDRemoteStats *pStats);
+
+#endif
@@ -0,0 +1,180 @@
+/**
+ * @file i2cLCDRemoteProto.h
+ * @author Hisayuki Nomura
+ * @brief PCから液晶の表示を送る、差分の通信プロトコルの定義。液晶側（Pico）とPC側（host/）の両方でincludeする。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details このヘッダファイルは、pico SDKに依存しない。標準のCライブラリだけで、PCでもコンパイルできる。\n
+ * フレームの形式は次の通り。数値はすべて１バイト。CRCはCRC-16/CCITT-FALSE（初期値0xFFFF）で、seqからpayloadの最後までを計算し、下位、上位の順に送る。
+ * @code
+ *  [SOF(0xA5)][seq][type][length][payload × length][crc下位][crc上位]
+ * @endcode
+ * 種類(type)ごとのpayloadは次の通り。
+ * - LCD_REMOTE_CELLS　[行][DDRAMのカラム][文字...]　連続したセルの内容
+ * - LCD_REMOTE_ICONS　[アイコンのアドレス][値]...　アイコンのビット（アドレスと値の組の繰り返し）
+ * - LCD_REMOTE_GLYPH　[文字コード(0～7)][パターン×8]　CGRAMの外字
+ * - LCD_REMOTE_CURSOR　[行][カラム][フラグ]　カーソルの位置と形（LCD_REMOTE_CURSOR_xxxのビット）
+ * - LCD_REMOTE_RESET　なし　この後に画面全体を送り直す。液晶側は、このフレームの番号から数え直す。
+ * - LCD_REMOTE_NAK　[次に期待する番号]　液晶側からPCへ、番号の抜けを知らせて画面全体の再送を求める。
+ *
+ * PCは、フレームを送るたびにseqを１つ増やす（255の次は０）。液晶側は、期待する番号と異なるフレームを受け取ると、
+ * それ以降のフレームを捨ててLCD_REMOTE_NAKを返し、LCD_REMOTE_RESETを受け取るまで待つ。
+ * 通信路のノイズなどで壊れたフレームはCRCで捨て、次のSOFからフレームを探し直す。
+ */
+#ifndef __i2cLCDRemoteProto_h__
+#define __i2cLCDRemoteProto_h__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/// @brief フレームの先頭を示すバイト
+#define LCD_REMOTE_SOF          0xA5
+/// @brief payloadの最大の長さ。DDRAMの１行分（40文字）と行、カラムが入る。
+#define LCD_REMOTE_PAYLOAD_MAX  48
+/// @brief フレームの最大の長さ
+#define LCD_REMOTE_FRAME_MAX    (LCD_REMOTE_PAYLOAD_MAX + 6)
+
+/// @brief プロトコルで扱う行数（ST7032のDDRAMの行数）
+#define LCD_REMOTE_LINES        2
+/// @brief プロトコルで扱う１行あたりのカラム数（ST7032のDDRAMの１行の文字数）
+#define LCD_REMOTE_COLUMNS      40
+
+/// @brief 種類：連続したセルの内容
+#define LCD_REMOTE_CELLS        0x01
+/// @brief 種類：アイコンのビット
+#define LCD_REMOTE_ICONS        0x02
+/// @brief 種類：CGRAMの外字
+#define LCD_REMOTE_GLYPH        0x03
+/// @brief 種類：カーソルの位置と形
+#define LCD_REMOTE_CURSOR       0x04
+/// @brief 種類：番号を数え直し、画面全体を送り直す
+#define LCD_REMOTE_RESET        0x10
+/// @brief 種類：液晶側からの再送の要求
+#define LCD_REMOTE_NAK          0x80
+
+/// @brief カーソルのフラグ：カーソルを表示する
+#define LCD_REMOTE_CURSOR_VISIBLE   0x01
+/// @brief カーソルのフラグ：下線
+#define LCD_REMOTE_CURSOR_UNDERLINE 0x02
+/// @brief カーソルのフラグ：点滅
+#define LCD_REMOTE_CURSOR_BLINK     0x04
+
+/**
+ * @brief 受信したバイト列から、フレームを取り出すための状態。
+ */
+struct LCDRemoteParser {
+    /// @brief 受け取ったバイト数（SOFを除く）。０の場合はSOFを待っている。
+    uint8_t count;
+    /// @brief 受け取ったフレーム（seqからcrcまで）
+    uint8_t aryFrame[LCD_REMOTE_FRAME_MAX];
+    /// @brief 長さやCRCが正しくなかったフレームの数
+    uint32_t crcErrors;
+};
+
+/**
+ * @brief CRC-16/CCITT-FALSEを計算する。
+ *
+ * @param buf データ
+ * @param length 長さ
+ * @return uint16_t CRC
+ */
+static inline uint16_t lcd_RemoteCrc16(const uint8_t *buf, int length)
+{
+    uint16_t crc = 0xFFFF;
+    for (int i = 0; i < length; i++) {
+        crc ^= (uint16_t)buf[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+/**
+ * @brief フレームを組み立てる。
+ *
+ * @param buf フレームを入れるバッファ。LCD_REMOTE_FRAME_MAXバイト以上。
+ * @param seq フレームの番号
+ * @param type 種類
+ * @param pPayload payload
+ * @param length payloadの長さ（０～LCD_REMOTE_PAYLOAD_MAX）
+ * @return int フレームの長さ。payloadが長すぎる場合は-1。
+ */
+static inline int lcd_RemoteEncode(uint8_t *buf, uint8_t seq, uint8_t type, const uint8_t *pPayload, int length)
+{
+    if (length < 0 || length > LCD_REMOTE_PAYLOAD_MAX) return -1;
+    buf[0] = LCD_REMOTE_SOF;
+    buf[1] = seq;
+    buf[2] = type;
+    buf[3] = (uint8_t)length;
+    if (length > 0) memcpy(&buf[4], pPayload, length);
+    uint16_t crc = lcd_RemoteCrc16(&buf[1], length + 3);
+    buf[4 + length] = (uint8_t)(crc & 0xFF);
+    buf[5 + length] = (uint8_t)(crc >> 8);
+    return length + 6;
+}
+/**
+ * @brief フレームを取り出す状態を初期化する。
+ *
+ * @param pParser 状態
+ */
+static inline void lcd_RemoteParserInit(LCDRemoteParser *pParser)
+{
+    memset(pParser, 0, sizeof(LCDRemoteParser));
+}
+/**
+ * @brief 受信した１バイトを渡し、フレームが揃ったかを調べる。
+ *
+ * @param pParser 状態
+ * @param c 受信したバイト
+ * @return bool CRCの正しいフレームが揃った場合はtrue。aryFrame[0]がseq、[1]がtype、[2]がlength、[3]からがpayload。
+ * @details 長さやCRCが正しくない場合は、そのフレームの中にSOFがあれば、SOFの後のバイトをaryFrameの先頭に詰めて、
+ * そこからフレームを調べ直す。詰めたバイトはaryFrameの同じ位置に書き戻すことになるので、ほかのバッファは使わない。
+ * 調べ直している途中でフレームが揃った場合は、その後ろに残っていたバイトは捨てる（番号の抜けとして、再送で回復する）。
+ */
+static inline bool lcd_RemoteParse(LCDRemoteParser *pParser, uint8_t c)
+{
+    if (pParser->count == 0) {
+        if (c == LCD_REMOTE_SOF) pParser->count = 1;
+        return false;
+    }
+    pParser->aryFrame[pParser->count - 1] = c;
+    int held = pParser->count;              // aryFrameに入っているバイト数
+    int used = held;                        // そのうち、今のフレームとして調べたバイト数
+    while (true) {
+        bool isBroken = false;
+        if (used == 3 && pParser->aryFrame[2] > LCD_REMOTE_PAYLOAD_MAX) {
+            isBroken = true;                    // 長さが壊れている
+        } else if (used >= 3 && used == pParser->aryFrame[2] + 5) {
+            int length = pParser->aryFrame[2];
+            uint16_t crc = pParser->aryFrame[3 + length] | (uint16_t)(pParser->aryFrame[4 + length] << 8);
+            if (lcd_RemoteCrc16(pParser->aryFrame, length + 3) == crc) {
+                pParser->count = 0;
+                return true;
+            }
+            isBroken = true;
+        }
+        if (isBroken) {
+            pParser->crcErrors++;
+            int sof = 0;
+            while (sof < held && pParser->aryFrame[sof] != LCD_REMOTE_SOF) sof++;
+            if (sof == held) {
+                pParser->count = 0;
+                return false;
+            }
+            held -= sof + 1;
+            memmove(pParser->aryFrame, &pParser->aryFrame[sof + 1], held);
+            used = 0;
+        }
+        if (used == held) break;
+        used++;
+    }
+    pParser->count = held + 1;
+    return false;
+}
+
+#endif
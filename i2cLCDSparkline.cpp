@@ -0,0 +1,136 @@
+/**
+ * @file i2cLCDSparkline.cpp
+ * @author Hisayuki Nomura
+ * @brief センサーの値の推移を、外字のピクセルキャンバスに折れ線グラフ（スパークライン）で表示するための処理。\n
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details サンプルをリングバッファに保存し、lcd_SparklinePush()で新しいサンプルを追加するたびに、グラフを１ドット左にずらして描き直す。
+ * 描き直しはピクセルキャンバス（i2cLCDPixel.cpp）のバッファに対して行い、点の状態が変わったCGRAMの行にだけ印が付く。
+ * lcd_PixelFlush()で送信されるのは、ずらした結果、実際に変わった行だけになる。値が平らな部分は、ずらしても送信されない。
+ *
+ * @code
+ *  static LCDSparkline spark;
+ *  lcd_SparklineInit(&spark, 0, 12, 4, 2);
+ *  lcd_SparklineRangeSet(&spark, 0, 1000);
+ *  lcd_Flush();
+ *  while (true) {
+ *      lcd_SparklinePush(&spark, readSensor());
+ *      lcd_PixelFlush();
+ *      sleep_ms(100);
+ *  }
+ * @endcode
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "i2cLCD.h"
+#include "i2cLCDlocal.h"
+#include "i2cLCDSparkline.h"
+
+/**
+ * @brief スパークラインを初期化し、ピクセルキャンバスを画面に並べる。
+ *
+ * @param pSpark スパークライン
+ * @param line 画面に置く先頭の行
+ * @param column 画面に置く先頭のカラム（DDRAMのカラム）
+ * @param cols 横の文字数
+ * @param rows 縦の行数。cols×rowsは８以下。
+ * @return int ０。範囲外の場合は-1。
+ * @details 外字をすべて使うピクセルキャンバスを初期化するので、ほかの外字とは同時に使えない。
+ * 表示する範囲は、最初は自動（保存しているサンプルの最小値から最大値）になる。
+ */
+int lcd_SparklineInit(LCDSparkline *pSpark, int line, int column, int cols, int rows)
+{
+    if (lcd_PixelInit(line, column, cols, rows) < 0) return -1;
+    memset(pSpark, 0, sizeof(LCDSparkline));
+    pSpark->width = cols * 5;
+    pSpark->height = rows * 8;
+    return 0;
+}
+/**
+ * @brief 表示する値の範囲を設定する。
+ *
+ * @param pSpark スパークライン
+ * @param minValue キャンバスの一番下に表示する値
+ * @param maxValue キャンバスの一番上に表示する値。minValue以下の場合は、保存しているサンプルに合わせて自動で決める。
+ * @return int 常に０
+ * @details 自動にすると、サンプルが範囲を広げるたびにグラフ全体の形が変わり、多くの行が送信される。
+ * 値の範囲が分かっている場合は、固定したほうが送信が少ない。
+ */
+int lcd_SparklineRangeSet(LCDSparkline *pSpark, int32_t minValue, int32_t maxValue)
+{
+    pSpark->minValue = minValue;
+    pSpark->maxValue = maxValue;
+    return 0;
+}
+/**
+ * @brief 線の下を塗りつぶすかを設定する。
+ *
+ * @param pSpark スパークライン
+ * @param isFill trueの場合は塗りつぶす（棒グラフのような表示）。falseの場合は線だけ。
+ * @return int 常に０
+ */
+int lcd_SparklineFillSet(LCDSparkline *pSpark, bool isFill)
+{
+    pSpark->isFill = isFill;
+    return 0;
+}
+/**
+ * @brief サンプルを追加し、グラフを１ドット左にずらしてキャンバスに描き直す。液晶にはまだ送信されない。
+ *
+ * @param pSpark スパークライン
+ * @param value サンプルの値
+ * @return int ０。lcd_SparklineInit()で初期化されていない場合（幅が０）は-1。
+ * @details 送信はlcd_PixelFlush()で行う。複数のサンプルを追加してから送信すると、途中の形の分は送信されない。
+ */
+int lcd_SparklinePush(LCDSparkline *pSpark, int32_t value)
+{
+    if (pSpark->width == 0) return -1;
+    pSpark->arySample[pSpark->head] = value;
+    pSpark->head = (pSpark->head + 1) % pSpark->width;
+    if (pSpark->count < pSpark->width) pSpark->count++;
+
+    int oldest = (pSpark->head + pSpark->width - pSpark->count) % pSpark->width;
+    int32_t minValue = pSpark->minValue;
+    int32_t maxValue = pSpark->maxValue;
+    if (maxValue <= minValue) {
+        minValue = maxValue = pSpark->arySample[oldest];
+        for (int i = 1; i < pSpark->count; i++) {
+            int32_t v = pSpark->arySample[(oldest + i) % pSpark->width];
+            if (v < minValue) minValue = v;
+            if (v > maxValue) maxValue = v;
+        }
+    }
+    int64_t range = (int64_t)maxValue - minValue;
+    int prevY = -1;
+    // 右端に新しいサンプルが来るように、左の空いた列は空白にする
+    for (int x = 0; x < pSpark->width; x++) {
+        int index = x - (pSpark->width - pSpark->count);
+        int y = -1;
+        if (index >= 0) {
+            int64_t v = pSpark->arySample[(oldest + index) % pSpark->width];
+            if (v < minValue) v = minValue;
+            if (v > maxValue) v = maxValue;
+            y = (range == 0) ? pSpark->height / 2 : pSpark->height - 1 - (int)((v - minValue) * (pSpark->height - 1) / range);
+        }
+        // 前の点から縦につないで、急な変化も線が途切れないようにする
+        int top = y;
+        int bottom = pSpark->isFill ? pSpark->height - 1 : y;
+        if (!pSpark->isFill && y >= 0 && prevY >= 0) {
+            if (prevY < y) top = prevY + 1;
+            if (prevY > y) bottom = prevY - 1;
+        }
+        for (int py = 0; py < pSpark->height; py++) {
+            lcd_PixelSet(x, py, y >= 0 && py >= top && py <= bottom);
+        }
+        prevY = y;
+    }
+    return 0;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file i2cLCDSparkline.h
+ * @author Hisayuki Nomura
+ * @brief センサーの値の推移を、外字のピクセルキャンバスに折れ線グラフ（スパークライン）で表示するためのヘッダファイル。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details スパークラインを使用するプログラムは、i2cLCD.hに続けてこのヘッダファイルをincludeする。
+ * i2cLCDPixel.cppも必要。
+ */
+#ifndef __i2cLCDSparkline_h__
+#define __i2cLCDSparkline_h__
+
+#include "i2cLCD.h"
+#include "i2cLCDPixel.h"
+
+/// @brief 保存するサンプルの最大の数。キャンバスの最大の幅（外字８文字を横に並べた40ドット）と同じ。
+#define LCD_SPARKLINE_SAMPLES   40
+
+/**
+ * @brief スパークライン。アプリケーションが静的に確保し、lcd_SparklineInit()で初期化する。
+ * @details サンプルはリングバッファに保存し、１ドットの幅に１つのサンプルを表示する。新しいサンプルが右端になる。
+ */
+struct LCDSparkline {
+    /// @brief サンプルのリングバッファ
+    int32_t arySample[LCD_SPARKLINE_SAMPLES];
+    /// @brief 次にサンプルを書き込む位置
+    uint8_t head;
+    /// @brief 保存しているサンプルの数（最大はwidth）
+    uint8_t count;
+    /// @brief キャンバスの幅（ドット数）。表示するサンプルの数になる。
+    uint8_t width;
+    /// @brief キャンバスの高さ（ドット数）
+    uint8_t height;
+    /// @brief trueの場合は、線の下を塗りつぶす
+    bool isFill;
+    /// @brief 表示する範囲の最小値
+    int32_t minValue;
+    /// @brief 表示する範囲の最大値。minValue以下の場合は、保存しているサンプルの最小値と最大値に合わせる。
+    int32_t maxValue;
+};
+
+int lcd_SparklineInit(LCDSparkline *pSpark, int line, int column, int cols, int rows);
+int lcd_SparklineRangeSet(LCDSparkline *pSpark, int32_t minValue, int32_t maxValue);
+int lcd_SparklineFillSet(LCDSparkline *pSpark, bool isFill);
+int lcd_SparklinePush(LCDSparkline *pSpark, int32_t value);
+
+#endif
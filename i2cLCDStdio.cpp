@@ -0,0 +1,139 @@
+/**
+ * @file i2cLCDStdio.cpp
+ * @author Hisayuki Nomura
+ * @brief 液晶をpico SDKの標準出力のドライバとして登録し、printfやputsの出力を液晶に表示するための処理。\n
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details lcd_printfは、呼び出すたびにフォーマットした文字列をすぐに送信し、SDKの標準出力とは関係がない。\n
+ * このファイルは、液晶をstdio_driver_tとして登録し、printfやputsの出力を、UARTやUSBと一緒に（またはその代わりに）液晶に出す。
+ * 出力された文字はコンソール（LCDConsole）のリングバッファと表示内容のモデルに書き込むだけで、すぐには送信しない。
+ * 改行を出力したときか、LCD_STDIO_FLUSH_USが過ぎたときに、それまでの出力をまとめて、変わったセルだけを送信する。
+ * そのため、短い出力を何度も繰り返しても、呼び出しごとにトランザクションが発生することはない。
+ *
+ * @code
+ *  lcd_init();
+ *  lcd_StdioInit(0, MAX_LINES);        // 液晶の全部の行を標準出力に使う
+ *  printf("temp=%d\n", temp);          // UARTと液晶の両方に出力される
+ *  while (true) {
+ *      lcd_StdioPoll();                // 改行の無い出力も、LCD_STDIO_FLUSH_US後に表示される
+ *  }
+ * @endcode
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "pico/stdio/driver.h"
+#include "hardware/i2c.h"
+#include "i2cLCD.h"
+#include "i2cLCDlocal.h"
+#include "i2cLCDConsole.h"
+#include "i2cLCDStdio.h"
+
+/// @brief 標準出力の内容を表示するコンソール
+static LCDConsole lcdStdioConsole;
+/// @brief 標準出力のドライバ
+static stdio_driver_t lcdStdioDriver;
+/// @brief まだ送信していない出力がある場合はtrue
+static bool isStdioPending = false;
+/// @brief 最後に送信した時刻（time_us_64()の値）
+static uint64_t stdioFlushedAt = 0;
+/// @brief 送信していない出力を送信する時刻（time_us_64()の値）
+static uint64_t stdioDueAt = 0;
+
+/**
+ * @brief 送信していない出力があり、送信する時刻を過ぎていれば送信する。
+ *
+ * @param isForce trueの場合は、時刻にかかわらず送信する
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ */
+static int lcd_StdioFlushPending(bool isForce)
+{
+    if (!isStdioPending) return 0;
+    uint64_t now = time_us_64();
+    if (!isForce && now < stdioDueAt) return 0;
+    isStdioPending = false;
+    stdioFlushedAt = now;
+    return lcd_Flush();
+}
+/**
+ * @brief 標準出力のドライバから呼び出され、出力された文字をコンソールに書き込む。
+ *
+ * @param buf 出力された文字
+ * @param length 文字数
+ * @details 改行が含まれている場合は、前回の送信からLCD_STDIO_FLUSH_US以上過ぎていればすぐに送信し、
+ * 続けて出力された場合は、前回の送信からLCD_STDIO_FLUSH_US後にまとめて送信する。
+ * 改行が無い場合は、最初の出力からLCD_STDIO_FLUSH_US後に送信する。
+ */
+static void lcd_StdioOutChars(const char *buf, int length)
+{
+    uint64_t now = time_us_64();
+    lcd_ConsoleWrite(&lcdStdioConsole, buf, length);
+    if (!isStdioPending) {
+        isStdioPending = true;
+        stdioDueAt = now + LCD_STDIO_FLUSH_US;
+    }
+    if (memchr(buf, '\n', length) != NULL) {
+        uint64_t at = stdioFlushedAt + LCD_STDIO_FLUSH_US;
+        if (at < now) at = now;
+        if (at < stdioDueAt) stdioDueAt = at;
+    }
+    lcd_StdioFlushPending(false);
+}
+/**
+ * @brief fflush(stdout)などで、標準出力のドライバから呼び出される。送信していない出力をすべて送信する。
+ */
+static void lcd_StdioOutFlush(void)
+{
+    lcd_StdioFlushPending(true);
+}
+/**
+ * @brief 液晶を標準出力のドライバとして登録する。
+ *
+ * @param line 標準出力に使う最初の行
+ * @param height 標準出力に使う行数
+ * @return int ０。画面からはみ出す場合は-1。
+ * @details lcd_init()の後に呼び出す。登録すると、printfなどの出力が液晶にも表示される。
+ * UARTやUSBの出力も有効な場合は、両方に出力される。液晶だけに出力する場合は、CMakeLists.txtでUARTとUSBの出力を無効にする。
+ */
+int lcd_StdioInit(int line, int height)
+{
+    if (lcd_ConsoleInit(&lcdStdioConsole, line, height) < 0) return -1;
+    lcd_Flush();
+    lcdStdioDriver.out_chars = lcd_StdioOutChars;
+    lcdStdioDriver.out_flush = lcd_StdioOutFlush;
+    lcdStdioDriver.in_chars = NULL;
+    stdioFlushedAt = 0;
+    isStdioPending = false;
+    return lcd_StdioEnable(true);
+}
+/**
+ * @brief 液晶への標準出力を有効/無効にする。
+ *
+ * @param isEnable trueの場合、printfなどの出力を液晶に表示する
+ * @return int 常に０
+ * @details 無効にする前に、送信していない出力を送信する。
+ */
+int lcd_StdioEnable(bool isEnable)
+{
+    if (!isEnable) {
+        lcd_StdioFlushPending(true);
+    }
+    stdio_set_driver_enabled(&lcdStdioDriver, isEnable);
+    return 0;
+}
+/**
+ * @brief 改行の無い出力や、続けて出力されたため送信を待っている出力を、送信する時刻を過ぎていれば送信する。
+ *
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ * @details メインループなどから定期的に呼び出す。
+ */
+int lcd_StdioPoll(void)
+{
+    return lcd_StdioFlushPending(false);
+}
@@ -0,0 +1,26 @@
+/**
+ * @file i2cLCDStdio.h
+ * @author Hisayuki Nomura
+ * @brief 液晶をpico SDKの標準出力のドライバとして登録し、printfやputsの出力を液晶に表示するためのヘッダファイル。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details 標準出力のドライバを使用するプログラムは、i2cLCD.hに続けてこのヘッダファイルをincludeする。
+ * 出力はコンソール（i2cLCDConsole.cpp）に書き込まれるので、i2cLCDConsole.cppもプロジェクトに組み込む。
+ */
+#ifndef __i2cLCDStdio_h__
+#define __i2cLCDStdio_h__
+
+#include "i2cLCD.h"
+
+/// @brief 出力を液晶に送信する最短の間隔（μ秒）。この間に出力された内容は、まとめて送信される。
+#define LCD_STDIO_FLUSH_US      20000
+
+int lcd_StdioInit(int line, int height);
+int lcd_StdioEnable(bool isEnable);
+int lcd_StdioPoll(void);
+
+#endif
@@ -0,0 +1,133 @@
+/**
+ * @file i2cLCDTemplate.cpp
+ * @author Hisayuki Nomura
+ * @brief 固定の文字列と、値を表示する欄（スロット）を分けた画面のテンプレートを使うための処理。\n
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details "TEMP:    C"のような見出しは画面に入るときに１度だけ送信し、その後は値の欄だけを更新すれば、送信量は値の文字数だけになる。\n
+ * テンプレートの固定の文字列は、コンパイル時にI2Cの送信データの形にしてあるので、最初に画面に入るときは、組み立てずにそのまま送信する。
+ * 別のテンプレートから切り替える場合は、表示内容のモデルを通して前の画面との差分だけを送信するので、
+ * 両方の画面に共通の見出しは送信し直さない。
+ *
+ * @code
+ *  lcd_TemplateEnter(&tmplMain);
+ *  while (true) {
+ *      lcd_TemplateSlotPrintf(0, "%4d", temp);
+ *      lcd_TemplateSlotPrintf(1, "%5d", rpm);
+ *      lcd_flush_step(500);
+ *  }
+ * @endcode
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "i2cLCD.h"
+#include "i2cLCDlocal.h"
+#include "i2cLCDTemplate.h"
+
+/// @brief 現在表示しているテンプレート。NULLの場合は、画面の内容がテンプレートと関係ない。
+static const LCDTemplate *pCurrentTemplate = NULL;
+
+/**
+ * @brief テンプレートの画面に入る。固定の文字列を表示する。
+ *
+ * @param pTmpl 表示するテンプレート
+ * @return int 送信したバイト数。負の値の場合はエラー。
+ * @details テンプレートを表示していない状態から入る場合は、送信データをそのまま１行につき１回のトランザクションで送信する。
+ * 別のテンプレートから切り替える場合は、固定の文字列を表示内容のモデルに書き込み、前の画面と異なる部分だけを送信する。\n
+ * フレームレートの制限やトランザクションの中、オーバーレイを表示している場合などは、モデルに書き込むだけで、送信はlcd_Flush()などで行う。
+ */
+int lcd_TemplateEnter(const LCDTemplate *pTmpl)
+{
+    int iSendBytes = 0;
+    int iRet;
+    bool isDirect = pCurrentTemplate == NULL && !lcd_IsBuffered() && !lcdSetting.isDisplayToLeft
+        && lcdModel.overlayCount == 0 && !lcdModel.isPageFlip;
+    pCurrentTemplate = pTmpl;
+    if (!isDirect) {
+        for (int line = 0; line < MAX_LINES; line++) {
+            lcd_ModelWrite(line, 0, (const char *)&pTmpl->aryLine[line][3], MAX_CHARS);
+        }
+        if (lcd_IsBuffered() || lcdModel.overlayCount > 0) return 0;
+        return lcd_Flush();
+    }
+    for (int line = 0; line < MAX_LINES; line++) {
+        const uint8_t *pText = &pTmpl->aryLine[line][3];
+        if (memcmp(pText, lcdModel.arySent[line], MAX_CHARS) == 0
+            && memcmp(pText, lcdModel.aryCell[line], MAX_CHARS) == 0) continue;     // 既に表示されている
+        iRet = lcd_BusWrite(pTmpl->aryLine[line], LCD_TEMPLATE_LINE_BYTES, CMD_DELAY);
+        if (iRet < 0) {
+            lcdSetting.hwAddr = 0xFF;
+            return iRet;
+        }
+        iSendBytes += iRet;
+        lcd_ModelMirror(line, 0, pText, MAX_CHARS);
+        lcdSetting.hwAddr = lcd_DDRAMAddr(line, MAX_CHARS);
+    }
+    // 表示されているカーソルが、書き込んだ場所に移動してしまっているので元に戻す
+    if (iSendBytes > 0 && lcdSetting.isCursorDisplay) {
+        iRet = lcd_CursorAddrSet(lcdSetting.curPosLine, lcdSetting.curPosColumn);
+        if (iRet < 0) return iRet;
+        iSendBytes += iRet;
+    }
+    return iSendBytes;
+}
+/**
+ * @brief 現在表示しているテンプレートを忘れる。
+ *
+ * @return int 常に０
+ * @details テンプレートと関係のない画面を表示した後に呼び出す。次のlcd_TemplateEnter()では、固定の文字列をそのまま送信する。
+ */
+int lcd_TemplateInvalidate(void)
+{
+    pCurrentTemplate = NULL;
+    return 0;
+}
+/**
+ * @brief 現在のテンプレートの、値を表示する欄に文字列を書き込む。液晶にはまだ送信されない。
+ *
+ * @param slot 欄の番号（LCDTemplate.pSlotsの添え字）
+ * @param s 書き込む文字列
+ * @param length 書き込む長さ。負の値の場合は文字列の長さ（NULL文字まで）。
+ * @return int 書き込んだ文字数。欄の幅を超えた部分は捨て、足りない部分は空白で埋める。テンプレートに入っていないか、欄が無い場合は-1。
+ * @details 表示内容のモデルに書き込むので、前の値と異なる文字だけが、lcd_Flush()やlcd_flush_step()で送信される。
+ */
+int lcd_TemplateSlotWrite(int slot, const char *s, int length)
+{
+    if (pCurrentTemplate == NULL || slot < 0 || slot >= pCurrentTemplate->slotCount) return -1;
+    const LCDTemplateSlot *pSlot = &pCurrentTemplate->pSlots[slot];
+    if (length < 0) {
+        length = strlen(s);
+    }
+    if (length > pSlot->width) {
+        length = pSlot->width;
+    }
+    lcd_ModelWrite(pSlot->line, pSlot->column, s, length);
+    lcd_ModelFill(pSlot->line, pSlot->column + length, ' ', pSlot->width - length);
+    return length;
+}
+/**
+ * @brief 現在のテンプレートの、値を表示する欄にフォーマットされた文字列を書き込む。液晶にはまだ送信されない。
+ *
+ * @param slot 欄の番号
+ * @param format C標準のprintfフォーマット
+ * @param ...
+ * @return int 書き込んだ文字数。テンプレートに入っていないか、欄が無い場合は-1。
+ */
+int lcd_TemplateSlotPrintf(int slot, const char *format, ...)
+{
+    char aryBuf[MAX_CHARS + 1];
+    va_list va;
+    va_start(va, format);
+    vsnprintf(aryBuf, sizeof(aryBuf), format, va);
+    va_end(va);
+    return lcd_TemplateSlotWrite(slot, aryBuf, -1);
+}
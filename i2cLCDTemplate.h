@@ -0,0 +1,84 @@
+/**
+ * @file i2cLCDTemplate.h
+ * @author Hisayuki Nomura
+ * @brief 固定の文字列と、値を表示する欄（スロット）を分けた画面のテンプレートを使うためのヘッダファイル。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details テンプレートを使用するプログラムは、i2cLCD.hに続けてこのヘッダファイルをincludeする。\n
+ * テンプレートはlcd_TemplateMake()でコンパイル時に作成し、I2Cでそのまま送信できる形でフラッシュメモリに置く。
+ * @code
+ *  static constexpr LCDTemplateSlot slotsMain[] = { {0, 5, 4}, {1, 4, 5} };
+ *  static constexpr LCDTemplate tmplMain = lcd_TemplateMake("TEMP:    C      "
+ *                                                           "RPM:            ", slotsMain, 2);
+ * @endcode
+ */
+#ifndef __i2cLCDTemplate_h__
+#define __i2cLCDTemplate_h__
+
+#include "i2cLCD.h"
+
+/// @brief テンプレートの１行分のバイト数。[0x80][DDRAMアドレス設定][0x40][文字×MAX_CHARS]
+#define LCD_TEMPLATE_LINE_BYTES (MAX_CHARS + 3)
+
+/**
+ * @brief テンプレートの中の、値を表示する欄
+ */
+struct LCDTemplateSlot {
+    /// @brief 行
+    uint8_t line;
+    /// @brief カラム
+    uint8_t column;
+    /// @brief 幅（文字数）
+    uint8_t width;
+};
+
+/**
+ * @brief 画面のテンプレート。lcd_TemplateMake()で作成する。
+ * @details aryLineには、固定の文字列を行ごとにI2Cの送信データの形（コントロールバイトとDDRAMアドレスの設定を含む）で持つ。
+ * 画面に初めて入るときは、これを１行につき１回のトランザクションでそのまま送信する。
+ */
+struct LCDTemplate {
+    /// @brief 行ごとの送信データ
+    uint8_t aryLine[MAX_LINES][LCD_TEMPLATE_LINE_BYTES];
+    /// @brief 値を表示する欄
+    const LCDTemplateSlot *pSlots;
+    /// @brief 値を表示する欄の数
+    uint8_t slotCount;
+};
+
+/**
+ * @brief 固定の文字列から、テンプレートをコンパイル時に作成する。
+ *
+ * @param text 固定の文字列。１行目のMAX_CHARS文字、２行目のMAX_CHARS文字...を続けて指定する。足りない部分は空白になる。
+ * @param pSlots 値を表示する欄の配列
+ * @param slotCount 値を表示する欄の数
+ * @return LCDTemplate 作成したテンプレート。constexprの変数に入れると、フラッシュメモリに置かれる。
+ */
+constexpr LCDTemplate lcd_TemplateMake(const char *text, const LCDTemplateSlot *pSlots, int slotCount)
+{
+    LCDTemplate tmpl = {};
+    bool isEnd = false;
+    for (int line = 0; line < MAX_LINES; line++) {
+        tmpl.aryLine[line][0] = 0x80;                               // 続けてコマンド
+        tmpl.aryLine[line][1] = 0x80 | (line == 0 ? 0x00 : 0x40);   // SETDDRAMADDR（行の先頭）
+        tmpl.aryLine[line][2] = 0x40;                               // 以降はすべてデータ
+        for (int i = 0; i < MAX_CHARS; i++) {
+            if (!isEnd && text[line * MAX_CHARS + i] == '\0') isEnd = true;
+            tmpl.aryLine[line][3 + i] = isEnd ? ' ' : (uint8_t)text[line * MAX_CHARS + i];
+        }
+    }
+    tmpl.pSlots = pSlots;
+    tmpl.slotCount = slotCount;
+    return tmpl;
+}
+
+int lcd_TemplateEnter(const LCDTemplate *pTmpl);
+int lcd_TemplateInvalidate(void);
+int lcd_TemplateSlotWrite(int slot, const char *s, int length);
+int lcd_TemplateSlotPrintf(int slot, const char *format, ...);
+
+#endif
@@ -0,0 +1,100 @@
+/**
+ * @file i2cLCDText.cpp
+ * @author Hisayuki Nomura
+ * @brief 文字列を矩形の範囲に配置して、表示内容のモデルに書き込むための処理。\n
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details lcd_stringは、カーソルの位置から文字をそのまま書き込むだけで、画面の幅や行の区切りを考えない。
+ * 空白で埋めたり、幅に合わせて切り詰めたりするには、呼び出し側でlcd_printfを重ねる必要があった。\n
+ * ここでは、lcd_TextLayout()で求めた配置に従って、文字列の一部と空白、省略記号をモデルに直接書き込む。
+ * 作業用の文字列は作らない。範囲の全体を毎回書き込むが、送信されるのはモデルの差分として実際に変わったセルだけになる。
+ *
+ * @code
+ *  lcd_TextBox(0, 0, 16, 2, message, LCD_TEXT_LEFT, true, true);
+ *  lcd_flush_step(500);
+ * @endcode
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "i2cLCD.h"
+#include "i2cLCDlocal.h"
+#include "i2cLCDText.h"
+
+/**
+ * @brief 配置した文字列を、表示内容のモデルに書き込む。液晶にはまだ送信されない。
+ *
+ * @param line 範囲の先頭の行
+ * @param column 範囲の先頭のカラム（DDRAMのカラム）
+ * @param pLayout lcd_TextLayout()で作成した配置
+ * @param pri 送信の優先度
+ * @return int 書き込んだセルの数。行やカラムが範囲外の場合は-1。
+ * @details 範囲の中で、文字の無い部分は空白で埋める。DDRAMの右端や最後の行を超える部分は書き込まない。
+ */
+int lcd_TextDraw(int line, int column, const LCDTextLayout *pLayout, LCD_PRIORITY pri)
+{
+    if (line < 0 || line >= MAX_LINES || column < 0 || column >= DDRAM_CHARS) return -1;
+    int count = 0;
+    for (int row = 0; row < pLayout->height && line + row < MAX_LINES; row++) {
+        int col = column;
+        int rest = pLayout->width;
+        if (row < pLayout->lineCount) {
+            const LCDTextRun *pRun = &pLayout->aryRun[row];
+            if (pRun->indent > 0) {
+                lcd_ModelFill(line + row, col, ' ', pRun->indent, pri);
+            }
+            col += pRun->indent;
+            if (pRun->length > 0 && col < DDRAM_CHARS) {
+                lcd_ModelWrite(line + row, col, &pLayout->pText[pRun->from], pRun->length, pri);
+            }
+            col += pRun->length;
+            if (pRun->isEllipsis && col < DDRAM_CHARS) {
+                lcd_ModelFill(line + row, col, (char)LCD_TEXT_ELLIPSIS, 1, pri);
+            }
+            col += pRun->isEllipsis ? 1 : 0;
+            rest -= col - column;
+        }
+        if (rest > 0 && col < DDRAM_CHARS) {
+            lcd_ModelFill(line + row, col, ' ', rest, pri);
+        }
+        count += (column + pLayout->width > DDRAM_CHARS) ? DDRAM_CHARS - column : pLayout->width;
+    }
+    return count;
+}
+/**
+ * @brief 配置した文字列を、通常の優先度で表示内容のモデルに書き込む。
+ *
+ * @param line 範囲の先頭の行
+ * @param column 範囲の先頭のカラム（DDRAMのカラム）
+ * @param pLayout lcd_TextLayout()で作成した配置
+ * @return int 書き込んだセルの数。行やカラムが範囲外の場合は-1。
+ */
+int lcd_TextDraw(int line, int column, const LCDTextLayout *pLayout)
+{
+    return lcd_TextDraw(line, column, pLayout, LCD_PRI_NORMAL);
+}
+/**
+ * @brief 文字列を範囲に配置して、表示内容のモデルに書き込む。実行時に変わる文字列に使う。
+ *
+ * @param line 範囲の先頭の行
+ * @param column 範囲の先頭のカラム（DDRAMのカラム）
+ * @param width 範囲の幅（文字数）
+ * @param height 範囲の高さ（行数）
+ * @param text 配置する文字列。'\n'で改行する。
+ * @param align 寄せ方向
+ * @param isWrap trueの場合は、単語の区切りで折り返す
+ * @param isEllipsis trueの場合は、切り詰めた行の最後を省略記号にする
+ * @return int 書き込んだセルの数。行やカラムが範囲外の場合は-1。
+ */
+int lcd_TextBox(int line, int column, int width, int height, const char *text, LCD_TEXT_ALIGN align, bool isWrap, bool isEllipsis)
+{
+    LCDTextLayout layout = lcd_TextLayout(text, width, height, align, isWrap, isEllipsis);
+    return lcd_TextDraw(line, column, &layout);
+}
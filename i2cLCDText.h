@@ -0,0 +1,168 @@
+/**
+ * @file i2cLCDText.h
+ * @author Hisayuki Nomura
+ * @brief 文字列を矩形の範囲に、寄せ方向、単語での折り返し、省略記号付きの切り詰めを指定して配置するためのヘッダファイル。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details 文字列の配置を使用するプログラムは、i2cLCD.hに続けてこのヘッダファイルをincludeする。\n
+ * lcd_TextLayout()はconstexprなので、文字列リテラルの配置はコンパイル時に計算できる。
+ * @code
+ *  static constexpr LCDTextLayout layoutHello = lcd_TextLayout("Hello, Raspberry Pi Pico!", 16, 2, LCD_TEXT_CENTER, true, true);
+ *  lcd_TextDraw(0, 0, &layoutHello);
+ *  lcd_Flush();
+ * @endcode
+ */
+#ifndef __i2cLCDText_h__
+#define __i2cLCDText_h__
+
+#include "i2cLCD.h"
+
+/// @brief 切り詰めた行の最後に表示する省略記号。ST7032のCGROMの「･」。
+#define LCD_TEXT_ELLIPSIS   0xA5
+
+/**
+ * @brief 行の中での寄せ方向
+ */
+enum LCD_TEXT_ALIGN : uint8_t {
+    /// @brief 左寄せ
+    LCD_TEXT_LEFT,
+    /// @brief 右寄せ
+    LCD_TEXT_RIGHT,
+    /// @brief 中央寄せ（余りが奇数の場合は左に寄る）
+    LCD_TEXT_CENTER
+};
+
+/**
+ * @brief 配置した１行分の情報。文字列の一部を指すだけで、文字はコピーしない。
+ */
+struct LCDTextRun {
+    /// @brief 行に表示する部分の、文字列の先頭からの位置
+    uint16_t from;
+    /// @brief 行に表示する文字数（省略記号を除く）
+    uint8_t length;
+    /// @brief 行の左端から、文字を表示するまでの空白の数
+    uint8_t indent;
+    /// @brief 行の最後に省略記号を表示する場合はtrue
+    bool isEllipsis;
+};
+
+/**
+ * @brief 文字列の配置。lcd_TextLayout()で作成し、lcd_TextDraw()で表示内容のモデルに書き込む。
+ */
+struct LCDTextLayout {
+    /// @brief 配置する文字列。lcd_TextDraw()を呼び出すまで有効であること。
+    const char *pText;
+    /// @brief 範囲の幅（文字数）
+    uint8_t width;
+    /// @brief 範囲の高さ（行数）
+    uint8_t height;
+    /// @brief 文字のある行数。これより下の行は空白になる。
+    uint8_t lineCount;
+    /// @brief 行ごとの配置
+    LCDTextRun aryRun[MAX_LINES];
+};
+
+/**
+ * @brief 文字列を範囲に配置する。文字列リテラルを指定して、constexprの変数に入れると、コンパイル時に計算される。
+ *
+ * @param text 配置する文字列。'\n'で改行する。
+ * @param length 文字列の長さ。負の値の場合はNULL文字まで。
+ * @param width 範囲の幅（文字数、１～DDRAM_CHARS）
+ * @param height 範囲の高さ（行数、１～MAX_LINES）
+ * @param align 寄せ方向
+ * @param isWrap trueの場合は、幅を超える行を単語の区切り（空白）で折り返す。区切りの無い長い単語は幅で分ける。
+ * falseの場合は、'\n'だけで改行し、幅を超える部分は切り詰める。
+ * @param isEllipsis trueの場合は、切り詰めた行の最後の文字をLCD_TEXT_ELLIPSISにする。
+ * @return LCDTextLayout 配置。
+ * @details 範囲に入らない文字がある場合は、最後の行を切り詰める。行の前後の空白は、寄せ方向の計算に含めない。
+ */
+constexpr LCDTextLayout lcd_TextLayout(const char *text, int length, int width, int height, LCD_TEXT_ALIGN align, bool isWrap, bool isEllipsis)
+{
+    LCDTextLayout layout = {};
+    if (width < 1) width = 1;
+    if (width > DDRAM_CHARS) width = DDRAM_CHARS;
+    if (height < 1) height = 1;
+    if (height > MAX_LINES) height = MAX_LINES;
+    if (length < 0) {
+        length = 0;
+        while (text[length] != '\0') length++;
+    }
+    layout.pText = text;
+    layout.width = width;
+    layout.height = height;
+    int pos = 0;
+    for (int row = 0; row < height && pos < length; row++) {
+        if (isWrap) {
+            while (pos < length && text[pos] == ' ') pos++;     // 折り返した行の先頭の空白は表示しない
+        }
+        int eol = pos;
+        while (eol < length && text[eol] != '\n') eol++;
+        int from = pos;
+        int to = eol;
+        while (to > from && text[to - 1] == ' ') to--;          // 行末の空白は幅に数えない
+        int next = eol + 1;
+        bool isCut = false;
+        if (row == height - 1) {
+            // 最後の行：入らない文字が残っていれば切り詰める
+            int rest = next;
+            while (rest < length && (text[rest] == ' ' || text[rest] == '\n')) rest++;
+            isCut = (to - from > width) || (rest < length);
+            next = length;
+        } else if (isWrap && to - from > width) {
+            int brk = -1;
+            for (int i = from + width; i > from; i--) {
+                if (text[i] == ' ') {
+                    brk = i;
+                    break;
+                }
+            }
+            to = (brk > from) ? brk : from + width;
+            // 折り返した空白と、その直後の改行１つは、次の行に持ち越さない
+            next = to;
+            while (next < eol && text[next] == ' ') next++;
+            if (next == eol && next < length) next++;
+        } else if (!isWrap && to - from > width) {
+            isCut = true;
+        }
+        int space = (isCut && isEllipsis) ? width - 1 : width;
+        if (to - from > space) to = from + space;
+        while (to > from && text[to - 1] == ' ') to--;
+        if (align != LCD_TEXT_LEFT) {
+            while (from < to && text[from] == ' ') from++;
+        }
+        int used = (to - from) + ((isCut && isEllipsis) ? 1 : 0);
+        LCDTextRun &run = layout.aryRun[row];
+        run.from = from;
+        run.length = to - from;
+        run.isEllipsis = isCut && isEllipsis;
+        run.indent = (align == LCD_TEXT_RIGHT) ? width - used : (align == LCD_TEXT_CENTER) ? (width - used) / 2 : 0;
+        layout.lineCount = row + 1;
+        pos = next;
+    }
+    return layout;
+}
+/**
+ * @brief 文字列を範囲に配置する。文字列はNULL文字までとする。
+ *
+ * @param text 配置する文字列。'\n'で改行する。
+ * @param width 範囲の幅（文字数）
+ * @param height 範囲の高さ（行数）
+ * @param align 寄せ方向
+ * @param isWrap trueの場合は、単語の区切りで折り返す
+ * @param isEllipsis trueの場合は、切り詰めた行の最後を省略記号にする
+ * @return LCDTextLayout 配置。
+ */
+constexpr LCDTextLayout lcd_TextLayout(const char *text, int width, int height, LCD_TEXT_ALIGN align, bool isWrap, bool isEllipsis)
+{
+    return lcd_TextLayout(text, -1, width, height, align, isWrap, isEllipsis);
+}
+
+int lcd_TextDraw(int line, int column, const LCDTextLayout *pLayout);
+int lcd_TextDraw(int line, int column, const LCDTextLayout *pLayout, LCD_PRIORITY pri);
+int lcd_TextBox(int line, int column, int width, int height, const char *text, LCD_TEXT_ALIGN align, bool isWrap, bool isEllipsis);
+
+#endif
@@ -0,0 +1,237 @@
+/**
+ * @file i2cLCDTicker.cpp
+ * @author Hisayuki Nomura
+ * @brief 文字列を１ドットずつ滑らかに流す、電光掲示板（ティッカー）のための処理。\n
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details 表示シフトやDDRAMの書き換えでは、文字単位（５ドット＋隙間）でしか動かせない。
+ * ティッカーは、画面に外字の文字コード０～cells-1を一度だけ並べ、その外字の形を毎回作り直すことで、１ドットずつ文字を流す。
+ * 文字の形はCGRAMへの描画のために、このファイルに持っている５×７ドットのフォント（ASCII 0x20～0x7E、１文字５バイト）から作る。\n
+ * lcd_TickerStep()はDDRAMには一切書き込まず、CGRAMだけを１回のトランザクションで書き換える。
+ * 送信量は文字列や位置によらず一定で、3＋cells×8バイトになる（cells=8で67バイト）。
+ * カーソルを表示している場合だけ、カーソル位置を戻す分（2バイト）が加わる。
+ * 100kHzでは１フレームがおよそ6ms、400kHzではおよそ1.5msなので、30ms～50ms間隔で呼び出せば十分に滑らかに流れる。
+ *
+ * @code
+ *  static LCDTicker ticker;
+ *  lcd_TickerInit(&ticker, 1, 0, 8, "Hello, Raspberry Pi Pico!");
+ *  lcd_Flush();
+ *  while (true) {
+ *      lcd_TickerStep(&ticker);
+ *      sleep_ms(40);
+ *  }
+ * @endcode
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "i2cLCD.h"
+#include "i2cLCDlocal.h"
+#include "i2cLCDTicker.h"
+
+/// @brief フォントの最初の文字
+#define TICKER_FONT_FIRST   0x20
+/// @brief フォントの最後の文字
+#define TICKER_FONT_LAST    0x7E
+
+/**
+ * @brief ５×７ドットのフォント。１文字を左から右の５列で表し、各バイトのビット０が一番上のドット。
+ * @details 液晶のROMの英数字に近い形にしてあるので、ほかの場所に表示している文字と並べても違和感が少ない。
+ */
+static const uint8_t aryTickerFont[TICKER_FONT_LAST - TICKER_FONT_FIRST + 1][5] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00},     // ' '
+    {0x00, 0x00, 0x5F, 0x00, 0x00},     // '!'
+    {0x00, 0x07, 0x00, 0x07, 0x00},     // '"'
+    {0x14, 0x7F, 0x14, 0x7F, 0x14},     // '#'
+    {0x24, 0x2A, 0x7F, 0x2A, 0x12},     // '$'
+    {0x23, 0x13, 0x08, 0x64, 0x62},     // '%'
+    {0x36, 0x49, 0x55, 0x22, 0x50},     // '&'
+    {0x00, 0x05, 0x03, 0x00, 0x00},     // '''
+    {0x00, 0x1C, 0x22, 0x41, 0x00},     // '('
+    {0x00, 0x41, 0x22, 0x1C, 0x00},     // ')'
+    {0x08, 0x2A, 0x1C, 0x2A, 0x08},     // '*'
+    {0x08, 0x08, 0x3E, 0x08, 0x08},     // '+'
+    {0x00, 0x50, 0x30, 0x00, 0x00},     // ','
+    {0x08, 0x08, 0x08, 0x08, 0x08},     // '-'
+    {0x00, 0x60, 0x60, 0x00, 0x00},     // '.'
+    {0x20, 0x10, 0x08, 0x04, 0x02},     // '/'
+    {0x3E, 0x51, 0x49, 0x45, 0x3E},     // '0'
+    {0x00, 0x42, 0x7F, 0x40, 0x00},     // '1'
+    {0x42, 0x61, 0x51, 0x49, 0x46},     // '2'
+    {0x21, 0x41, 0x45, 0x4B, 0x31},     // '3'
+    {0x18, 0x14, 0x12, 0x7F, 0x10},     // '4'
+    {0x27, 0x45, 0x45, 0x45, 0x39},     // '5'
+    {0x3C, 0x4A, 0x49, 0x49, 0x30},     // '6'
+    {0x01, 0x71, 0x09, 0x05, 0x03},     // '7'
+    {0x36, 0x49, 0x49, 0x49, 0x36},     // '8'
+    {0x06, 0x49, 0x49, 0x29, 0x1E},     // '9'
+    {0x00, 0x36, 0x36, 0x00, 0x00},     // ':'
+    {0x00, 0x56, 0x36, 0x00, 0x00},     // ';'
+    {0x08, 0x14, 0x22, 0x41, 0x00},     // '<'
+    {0x14, 0x14, 0x14, 0x14, 0x14},     // '='
+    {0x00, 0x41, 0x22, 0x14, 0x08},     // '>'
+    {0x02, 0x01, 0x51, 0x09, 0x06},     // '?'
+    {0x32, 0x49, 0x79, 0x41, 0x3E},     // '@'
+    {0x7E, 0x11, 0x11, 0x11, 0x7E},     // 'A'
+    {0x7F, 0x49, 0x49, 0x49, 0x36},     // 'B'
+    {0x3E, 0x41, 0x41, 0x41, 0x22},     // 'C'
+    {0x7F, 0x41, 0x41, 0x22, 0x1C},     // 'D'
+    {0x7F, 0x49, 0x49, 0x49, 0x41},     // 'E'
+    {0x7F, 0x09, 0x09, 0x09, 0x01},     // 'F'
+    {0x3E, 0x41, 0x49, 0x49, 0x7A},     // 'G'
+    {0x7F, 0x08, 0x08, 0x08, 0x7F},     // 'H'
+    {0x00, 0x41, 0x7F, 0x41, 0x00},     // 'I'
+    {0x20, 0x40, 0x41, 0x3F, 0x01},     // 'J'
+    {0x7F, 0x08, 0x14, 0x22, 0x41},     // 'K'
+    {0x7F, 0x40, 0x40, 0x40, 0x40},     // 'L'
+    {0x7F, 0x02, 0x0C, 0x02, 0x7F},     // 'M'
+    {0x7F, 0x04, 0x08, 0x10, 0x7F},     // 'N'
+    {0x3E, 0x41, 0x41, 0x41, 0x3E},     // 'O'
+    {0x7F, 0x09, 0x09, 0x09, 0x06},     // 'P'
+    {0x3E, 0x41, 0x51, 0x21, 0x5E},     // 'Q'
+    {0x7F, 0x09, 0x19, 0x29, 0x46},     // 'R'
+    {0x46, 0x49, 0x49, 0x49, 0x31},     // 'S'
+    {0x01, 0x01, 0x7F, 0x01, 0x01},     // 'T'
+    {0x3F, 0x40, 0x40, 0x40, 0x3F},     // 'U'
+    {0x1F, 0x20, 0x40, 0x20, 0x1F},     // 'V'
+    {0x3F, 0x40, 0x38, 0x40, 0x3F},     // 'W'
+    {0x63, 0x14, 0x08, 0x14, 0x63},     // 'X'
+    {0x07, 0x08, 0x70, 0x08, 0x07},     // 'Y'
+    {0x61, 0x51, 0x49, 0x45, 0x43},     // 'Z'
+    {0x00, 0x7F, 0x41, 0x41, 0x00},     // '['
+    {0x02, 0x04, 0x08, 0x10, 0x20},     // '\'
+    {0x00, 0x41, 0x41, 0x7F, 0x00},     // ']'
+    {0x04, 0x02, 0x01, 0x02, 0x04},     // '^'
+    {0x40, 0x40, 0x40, 0x40, 0x40},     // '_'
+    {0x00, 0x01, 0x02, 0x04, 0x00},     // '`'
+    {0x20, 0x54, 0x54, 0x54, 0x78},     // 'a'
+    {0x7F, 0x48, 0x44, 0x44, 0x38},     // 'b'
+    {0x38, 0x44, 0x44, 0x44, 0x20},     // 'c'
+    {0x38, 0x44, 0x44, 0x48, 0x7F},     // 'd'
+    {0x38, 0x54, 0x54, 0x54, 0x18},     // 'e'
+    {0x08, 0x7E, 0x09, 0x01, 0x02},     // 'f'
+    {0x0C, 0x52, 0x52, 0x52, 0x3E},     // 'g'
+    {0x7F, 0x08, 0x04, 0x04, 0x78},     // 'h'
+    {0x00, 0x44, 0x7D, 0x40, 0x00},     // 'i'
+    {0x20, 0x40, 0x44, 0x3D, 0x00},     // 'j'
+    {0x7F, 0x10, 0x28, 0x44, 0x00},     // 'k'
+    {0x00, 0x41, 0x7F, 0x40, 0x00},     // 'l'
+    {0x7C, 0x04, 0x18, 0x04, 0x78},     // 'm'
+    {0x7C, 0x08, 0x04, 0x04, 0x78},     // 'n'
+    {0x38, 0x44, 0x44, 0x44, 0x38},     // 'o'
+    {0x7C, 0x14, 0x14, 0x14, 0x08},     // 'p'
+    {0x08, 0x14, 0x14, 0x18, 0x7C},     // 'q'
+    {0x7C, 0x08, 0x04, 0x04, 0x08},     // 'r'
+    {0x48, 0x54, 0x54, 0x54, 0x20},     // 's'
+    {0x04, 0x3F, 0x44, 0x40, 0x20},     // 't'
+    {0x3C, 0x40, 0x40, 0x20, 0x7C},     // 'u'
+    {0x1C, 0x20, 0x40, 0x20, 0x1C},     // 'v'
+    {0x3C, 0x40, 0x30, 0x40, 0x3C},     // 'w'
+    {0x44, 0x28, 0x10, 0x28, 0x44},     // 'x'
+    {0x0C, 0x50, 0x50, 0x50, 0x3C},     // 'y'
+    {0x44, 0x64, 0x54, 0x4C, 0x44},     // 'z'
+    {0x00, 0x08, 0x36, 0x41, 0x00},     // '{'
+    {0x00, 0x00, 0x7F, 0x00, 0x00},     // '|'
+    {0x00, 0x41, 0x36, 0x08, 0x00},     // '}'
+    {0x08, 0x04, 0x08, 0x10, 0x08},     // '~'
+};
+
+/**
+ * @brief 流れる帯の１列分のドットを求める。
+ *
+ * @param pTicker ティッカー
+ * @param position 帯の先頭からのドット数
+ * @return uint8_t １列分のドット。ビット０が一番上。
+ * @details 帯は、文字列の後ろにティッカーの幅と同じ数の空白を付けたものとして扱う。
+ * 文字列が左に流れ切ってから、右端から次の周回が入ってくる。フォントに無い文字は空白にする。
+ */
+static uint8_t lcd_TickerColumn(const LCDTicker *pTicker, int position)
+{
+    int index = position / LCD_TICKER_ADVANCE;
+    int dot = position % LCD_TICKER_ADVANCE;
+    if (index >= pTicker->length || dot >= 5) return 0;
+    uint8_t code = (uint8_t)pTicker->pText[index];
+    if (code < TICKER_FONT_FIRST || code > TICKER_FONT_LAST) return 0;
+    return aryTickerFont[code - TICKER_FONT_FIRST][dot];
+}
+/**
+ * @brief ティッカーを初期化し、外字を画面に並べる。
+ *
+ * @param pTicker ティッカー
+ * @param line 画面に置く行
+ * @param column 画面に置く先頭のカラム（DDRAMのカラム）
+ * @param cells ティッカーの幅（文字数、１～８）
+ * @param text 流す文字列
+ * @return int ０。範囲外の場合は-1。
+ * @details 外字の文字コード０～cells-1を、表示内容のモデルに書き込む。液晶への送信はlcd_Flush()などで行う。
+ * この後は、lcd_TickerStep()を呼び出してもDDRAMは書き換えない。外字の形は、最初のlcd_TickerStep()で送信する。
+ */
+int lcd_TickerInit(LCDTicker *pTicker, int line, int column, int cells, const char *text)
+{
+    if (cells < 1 || cells > 8) return -1;
+    if (line < 0 || line >= MAX_LINES || column < 0 || column + cells > DDRAM_CHARS) return -1;
+    memset(pTicker, 0, sizeof(LCDTicker));
+    pTicker->cells = cells;
+    lcd_TickerTextSet(pTicker, text);
+    char aryCode[8];
+    for (int c = 0; c < cells; c++) {
+        aryCode[c] = (char)c;
+    }
+    lcd_ModelWrite(line, column, aryCode, cells);
+    return 0;
+}
+/**
+ * @brief 流す文字列を変更し、先頭から流し直す。
+ *
+ * @param pTicker ティッカー
+ * @param text 流す文字列。コピーしないので、流している間は残しておく必要がある。
+ * @return int 常に０
+ * @details 液晶には送信しない。次のlcd_TickerStep()から新しい文字列になる。
+ */
+int lcd_TickerTextSet(LCDTicker *pTicker, const char *text)
+{
+    size_t length = strlen(text);
+    pTicker->pText = text;
+    pTicker->length = (length > 0xFFFF / LCD_TICKER_ADVANCE - 8) ? 0xFFFF / LCD_TICKER_ADVANCE - 8 : (uint16_t)length;
+    pTicker->offset = 0;
+    return 0;
+}
+/**
+ * @brief 現在の位置の外字の形を作って送信し、位置を１ドット左に進める。
+ *
+ * @param pTicker ティッカー
+ * @return int i2cで送信したバイト数。負の値の場合はエラー。
+ * @details 送信は、SETCGRAMと外字cells文字分の形を１回のトランザクションで送るだけで、DDRAMは書き換えない。
+ * 送信量は毎回同じ3＋cells×8バイト（カーソルを表示している場合は＋2バイト）。
+ * 外字の境目は液晶の文字の隙間になるので、文字の間のドットが隙間に重なる位置では、文字の間が少し広く見える。
+ */
+int lcd_TickerStep(LCDTicker *pTicker)
+{
+    uint8_t aryPattern[8 * 8];
+    int total = (pTicker->length + pTicker->cells) * LCD_TICKER_ADVANCE;
+    for (int c = 0; c < pTicker->cells; c++) {
+        uint8_t aryColumn[5];
+        for (int x = 0; x < 5; x++) {
+            aryColumn[x] = lcd_TickerColumn(pTicker, (pTicker->offset + c * 5 + x) % total);
+        }
+        // 列ごとのフォントを、CGRAMの行ごとの形（下位５ビットが左から右）に並べ替える
+        for (int row = 0; row < 8; row++) {
+            uint8_t pattern = 0;
+            for (int x = 0; x < 5; x++) {
+                if (aryColumn[x] & (1 << row)) pattern |= 0x10 >> x;
+            }
+            aryPattern[c * 8 + row] = pattern;
+        }
+    }
+    int iSendBytes = lcd_CGRAMWrite(0, aryPattern, pTicker->cells * 8);
+    if (iSendBytes < 0) return iSendBytes;
+    pTicker->offset = (pTicker->offset + 1) % total;
+    return iSendBytes;
+}
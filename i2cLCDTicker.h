@@ -0,0 +1,40 @@
+/**
+ * @file i2cLCDTicker.h
+ * @author Hisayuki Nomura
+ * @brief 文字列を１ドットずつ滑らかに流す、電光掲示板（ティッカー）のためのヘッダファイル。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details ティッカーを使用するプログラムは、i2cLCD.hに続けてこのヘッダファイルをincludeする。\n
+ * 外字（CGRAM）を使用するので、ティッカーの幅は８文字まで。ほかの外字とは同時に使えない。
+ */
+#ifndef __i2cLCDTicker_h__
+#define __i2cLCDTicker_h__
+
+#include "i2cLCD.h"
+
+/// @brief １文字あたりのドット数（文字の５ドットと、文字の間の１ドット）
+#define LCD_TICKER_ADVANCE  6
+
+/**
+ * @brief ティッカー。アプリケーションが確保し、lcd_TickerInit()で初期化する。
+ */
+struct LCDTicker {
+    /// @brief 流す文字列。ティッカーは文字列をコピーせずに参照するので、流している間は残しておく必要がある。
+    const char *pText;
+    /// @brief 文字列の長さ
+    uint16_t length;
+    /// @brief 表示している左端の位置（文字列の先頭からのドット数）
+    uint16_t offset;
+    /// @brief ティッカーの幅（文字数、１～８）。外字の文字コード０～cells-1を使用する。
+    uint8_t cells;
+};
+
+int lcd_TickerInit(LCDTicker *pTicker, int line, int column, int cells, const char *text);
+int lcd_TickerTextSet(LCDTicker *pTicker, const char *text);
+int lcd_TickerStep(LCDTicker *pTicker);
+
+#endif
@@ -0,0 +1,527 @@
+/**
+ * @file i2cLCDWidget.cpp
+ * @author Hisayuki Nomura
+ * @brief ラベル、数値、アイコン、バーなどの部品（ウィジェット）を木構造で保持し、変わった部分だけを描画するための処理。\n
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details 値を表示するたびにlcd_CursorPositionとlcd_printfを組み合わせると、アプリケーションがそれぞれの値の位置を管理し、
+ * 値が変わっていなくても毎回すべての文字を送信することになる。\n
+ * ウィジェットは、位置と幅と表示する値を持ち、最後に描画した内容を覚えておく。lcd_WidgetRender()は、値が変わったウィジェットだけを描画し直し、
+ * 描画した結果が前回と異なる範囲だけを、表示内容のモデルに書き込む。液晶への送信はlcd_Flush()などで行う。\n
+ * ウィジェットはアプリケーションが静的に確保するので、メモリを動的に確保することはない。
+ *
+ * @code
+ *  static LCDWidget root, lblTemp, numTemp, barLevel;
+ *  lcd_WidgetContainerInit(&root, 0, 0);
+ *  lcd_WidgetLabelInit(&lblTemp, 0, 0, 5, "Temp:");
+ *  lcd_WidgetNumberInit(&numTemp, 0, 5, 4, 0);
+ *  lcd_WidgetBarInit(&barLevel, 1, 0, 16, 100);
+ *  lcd_WidgetAdd(&root, &lblTemp);
+ *  lcd_WidgetAdd(&root, &numTemp);
+ *  lcd_WidgetAdd(&root, &barLevel);
+ *  while (true) {
+ *      lcd_WidgetValueSet(&numTemp, temp);
+ *      lcd_WidgetValueSet(&barLevel, level);
+ *      lcd_WidgetRender(&root);
+ *      lcd_flush_step(500);
+ *  }
+ * @endcode
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "i2cLCD.h"
+#include "i2cLCDlocal.h"
+#include "i2cLCDWidget.h"
+
+/**
+ * @brief ウィジェットの共通部分を初期化する。
+ *
+ * @param pW ウィジェット
+ * @param type 種類
+ * @param line 親からの相対的な行
+ * @param column 親からの相対的なカラム
+ * @param width 幅
+ * @return int ０。位置や幅が範囲外の場合は-1。
+ */
+static int lcd_WidgetInit(LCDWidget *pW, LCD_WIDGET_TYPE type, int line, int column, int width)
+{
+    if (line < 0 || line >= MAX_LINES || column < 0 || column >= MAX_CHARS) return -1;
+    if (width < 0 || width > LCD_WIDGET_WIDTH_MAX) return -1;
+    memset(pW, 0, sizeof(LCDWidget));
+    pW->type = type;
+    pW->line = line;
+    pW->column = column;
+    pW->width = width;
+    pW->height = 1;
+    pW->isVisible = true;
+    pW->isChanged = true;
+    pW->pri = LCD_PRI_NORMAL;
+    return 0;
+}
+/**
+ * @brief 子のウィジェットをまとめる入れ物を初期化する。
+ *
+ * @param pW ウィジェット
+ * @param line 親からの相対的な行。子の位置は、この位置からの相対位置になる。
+ * @param column 親からの相対的なカラム
+ * @return int ０。範囲外の場合は-1。
+ * @details 入れ物を非表示にすると、中のウィジェットもまとめて非表示になる。
+ */
+int lcd_WidgetContainerInit(LCDWidget *pW, int line, int column)
+{
+    return lcd_WidgetInit(pW, LCD_WIDGET_CONTAINER, line, column, 0);
+}
+/**
+ * @brief 文字列を表示するラベルを初期化する。
+ *
+ * @param pW ウィジェット
+ * @param line 親からの相対的な行
+ * @param column 親からの相対的なカラム
+ * @param width 幅。文字列が短い場合は空白で埋め、長い場合は切り捨てる。
+ * @param pText 表示する文字列。ラベルは文字列をコピーせずに参照するので、表示している間は残しておく必要がある。
+ * @return int ０。範囲外の場合は-1。
+ */
+int lcd_WidgetLabelInit(LCDWidget *pW, int line, int column, int width, const char *pText)
+{
+    if (lcd_WidgetInit(pW, LCD_WIDGET_LABEL, line, column, width) < 0) return -1;
+    pW->pText = pText;
+    return 0;
+}
+/**
+ * @brief 整数を右寄せで表示する数値を初期化する。小数点や符号、寄せる方向はlcd_WidgetNumberFormatSet()で変更する。
+ *
+ * @param pW ウィジェット
+ * @param line 親からの相対的な行
+ * @param column 親からの相対的なカラム
+ * @param width 幅。値が幅に収まらない場合は、幅の分だけ'*'を表示する。
+ * @param value 最初の値
+ * @return int ０。範囲外の場合は-1。
+ */
+int lcd_WidgetNumberInit(LCDWidget *pW, int line, int column, int width, int32_t value)
+{
+    if (lcd_WidgetInit(pW, LCD_WIDGET_NUMBER, line, column, width) < 0) return -1;
+    pW->value = value;
+    return 0;
+}
+/**
+ * @brief 数値の表示形式を設定する。
+ *
+ * @param pW ウィジェット（LCD_WIDGET_NUMBER）
+ * @param align 幅の中に寄せる方向
+ * @param decimals 小数点以下の桁数（０～９）。例えば１の場合、値235を"23.5"と表示する。
+ * @param isPlusSign trueの場合、正の値に'+'を付ける
+ * @param isZeroPad trueの場合、右寄せの空いた桁を'0'で埋める（符号は先頭に付ける）
+ * @return int ０。数値のウィジェットでない場合や、桁数が範囲外の場合は-1。
+ */
+int lcd_WidgetNumberFormatSet(LCDWidget *pW, LCD_WIDGET_ALIGN align, int decimals, bool isPlusSign, bool isZeroPad)
+{
+    if (pW->type != LCD_WIDGET_NUMBER || decimals < 0 || decimals > 9) return -1;
+    pW->align = align;
+    pW->decimals = decimals;
+    pW->isPlusSign = isPlusSign;
+    pW->isZeroPad = isZeroPad;
+    pW->isChanged = true;
+    return 0;
+}
+/**
+ * @brief 数値の不感帯を設定する。センサーの値の細かい揺れで、送信が続かないようにする。
+ *
+ * @param pW ウィジェット（LCD_WIDGET_NUMBER）
+ * @param deadband 不感帯の幅（表示する値と同じ単位。小数点以下の桁がある場合は、小数点を除いた整数で指定する）。０の場合は不感帯なし。
+ * @return int ０。数値のウィジェットでない場合や、負の値の場合は-1。
+ * @details lcd_WidgetValueSet()で指定された値と、表示している値の差がdeadband未満の場合は、表示を変えない。
+ * 表示している値を基準に比べるので、値がゆっくり変わり続けた場合も、差がdeadbandに達した時点で表示が変わる。
+ */
+int lcd_WidgetDeadbandSet(LCDWidget *pW, int32_t deadband)
+{
+    if (pW->type != LCD_WIDGET_NUMBER || deadband < 0) return -1;
+    pW->deadband = deadband;
+    return 0;
+}
+/**
+ * @brief 値の大きさを横棒で表示するバーを初期化する。最初の値は０。
+ *
+ * @param pW ウィジェット
+ * @param line 親からの相対的な行
+ * @param column 親からの相対的なカラム
+ * @param width 幅。値がmaxValueのときに、幅いっぱいになる。
+ * @param maxValue 最大値
+ * @return int ０。範囲外の場合や、最大値が０以下の場合、部品を外字に登録できなかった場合は-1。
+ * @details １文字を５段階（１ドットの幅ごと）に分けて表示する。値が変わっても、書き換わるのは端の文字と、埋まった/空いた文字だけになる。\n
+ * 横棒の部品を外字に登録するので、縦棒（lcd_WidgetVBarInit()）とは同じ画面で使えない。後から初期化した方の部品になり、先のバーの形が崩れる。
+ */
+int lcd_WidgetBarInit(LCDWidget *pW, int line, int column, int width, int32_t maxValue)
+{
+    if (maxValue <= 0) return -1;
+    if (lcd_WidgetInit(pW, LCD_WIDGET_BAR, line, column, width) < 0) return -1;
+    pW->maxValue = maxValue;
+    if (lcdSetting.cgramOwner != LCD_CGRAM_OWNER_BAR) {
+        if (lcd_WidgetBarGlyphLoad(false) < 0) return -1;
+    }
+    return 0;
+}
+/**
+ * @brief 値の大きさを縦棒で表示するバーを初期化する。最初の値は０。
+ *
+ * @param pW ウィジェット
+ * @param line 親からの相対的な行（一番上の行）
+ * @param column 親からの相対的なカラム
+ * @param width 幅（縦棒の太さ、文字数）
+ * @param height 高さ（行数）。値がmaxValueのときに、高さいっぱいになる。
+ * @param maxValue 最大値
+ * @return int ０。範囲外の場合や、最大値が０以下の場合、部品を外字に登録できなかった場合は-1。
+ * @details 下から上に伸びる。１行を８段階に分けるので、MAX_LINES行で１６段階になる。\n
+ * 縦棒の部品を外字に登録するので、横棒（lcd_WidgetBarInit()）とは同じ画面で使えない。後から初期化した方の部品になり、先のバーの形が崩れる。
+ */
+int lcd_WidgetVBarInit(LCDWidget *pW, int line, int column, int width, int height, int32_t maxValue)
+{
+    if (maxValue <= 0 || height < 1 || height > MAX_LINES - line) return -1;
+    if (lcd_WidgetInit(pW, LCD_WIDGET_VBAR, line, column, width) < 0) return -1;
+    pW->height = height;
+    pW->maxValue = maxValue;
+    if (lcdSetting.cgramOwner != LCD_CGRAM_OWNER_VBAR) {
+        if (lcd_WidgetBarGlyphLoad(true) < 0) return -1;
+    }
+    return 0;
+}
+/**
+ * @brief バーの部品を外字に登録する。
+ *
+ * @param isVertical trueの場合は縦棒の部品（文字コード０～６）、falseの場合は横棒の部品（文字コード０～３）
+ * @return int i2cで送信したバイト数。負の値の場合はエラー。
+ * @details lcd_WidgetBarInit()とlcd_WidgetVBarInit()が最初に呼び出すので、通常は呼び出す必要はない。
+ * 部品は１回のトランザクションでまとめて登録し、その後の値の変更では外字を書き換えない。
+ * 横棒と縦棒は同じ文字コードを使うので、同時には使えない。\n
+ * ほかの機能（大きな数字、ピクセルキャンバス、ティッカー、lcd_CGRAMSet()など）で外字を書き換えると、次のlcd_WidgetBarInit()や
+ * lcd_WidgetVBarInit()で登録し直される。すでに初期化したバーを表示し続ける場合は、この関数で登録し直す。
+ */
+int lcd_WidgetBarGlyphLoad(bool isVertical)
+{
+    uint8_t aryPattern[LCD_WIDGET_VBAR_GLYPHS * 8];
+    int count = isVertical ? LCD_WIDGET_VBAR_GLYPHS : LCD_WIDGET_BAR_GLYPHS;
+    for (int code = 0; code < count; code++) {
+        for (int row = 0; row < 8; row++) {
+            if (isVertical) {
+                // 下からcode+1ドットの高さ
+                aryPattern[code * 8 + row] = (row >= 7 - code) ? 0x1F : 0x00;
+            } else {
+                // 左からcode+1ドットの幅
+                aryPattern[code * 8 + row] = (0x1F << (4 - code)) & 0x1F;
+            }
+        }
+    }
+    int iRet = lcd_CGRAMWrite(0, aryPattern, count * 8);
+    if (iRet < 0) return iRet;
+    lcdSetting.cgramOwner = isVertical ? LCD_CGRAM_OWNER_VBAR : LCD_CGRAM_OWNER_BAR;
+    return iRet;
+}
+#if LCD_ICONEXIST
+/**
+ * @brief アイコンを初期化する。最初は消去された状態。
+ *
+ * @param pW ウィジェット
+ * @param icon 表示/消去するアイコン
+ * @return int 常に０
+ * @details アイコンは文字の位置を持たないので、lcd_WidgetValueSet()で０以外を指定すると表示、０で消去する。
+ */
+int lcd_WidgetIconInit(LCDWidget *pW, LCD_ICON icon)
+{
+    lcd_WidgetInit(pW, LCD_WIDGET_ICON, 0, 0, 0);
+    pW->icon = icon;
+    return 0;
+}
+#endif
+/**
+ * @brief ウィジェットを、親のウィジェットの最後の子として追加する。
+ *
+ * @param pParent 親のウィジェット（LCD_WIDGET_CONTAINER）
+ * @param pChild 追加するウィジェット。まだどこにも追加されていないもの。
+ * @return int ０。親が入れ物でない場合や、既に追加されている場合は-1。
+ */
+int lcd_WidgetAdd(LCDWidget *pParent, LCDWidget *pChild)
+{
+    if (pParent->type != LCD_WIDGET_CONTAINER || pChild->pParent != NULL || pChild == pParent) return -1;
+    LCDWidget **ppLast = &pParent->pChild;
+    while (*ppLast != NULL) {
+        ppLast = &(*ppLast)->pNext;
+    }
+    *ppLast = pChild;
+    pChild->pParent = pParent;
+    pChild->pNext = NULL;
+    return 0;
+}
+/**
+ * @brief ラベルの文字列を変更する。
+ *
+ * @param pW ウィジェット
+ * @param pText 表示する文字列
+ * @return int 常に０
+ * @details 同じ文字列のバッファの中身を書き換えた場合も、この関数を呼ぶと描画し直す。
+ */
+int lcd_WidgetTextSet(LCDWidget *pW, const char *pText)
+{
+    pW->pText = pText;
+    pW->isChanged = true;
+    return 0;
+}
+/**
+ * @brief 数値、バー、アイコンの値を変更する。
+ *
+ * @param pW ウィジェット
+ * @param value 値
+ * @return int 常に０
+ * @details 値が変わらない場合は、描画し直さない。数値に不感帯（lcd_WidgetDeadbandSet）が設定されている場合、
+ * 表示している値との差が不感帯より小さい値は無視する。
+ */
+int lcd_WidgetValueSet(LCDWidget *pW, int32_t value)
+{
+    if (pW->type == LCD_WIDGET_NUMBER && pW->isShown && pW->deadband > 0
+        && llabs((int64_t)value - pW->value) < pW->deadband) return 0;
+    if (pW->value != value) {
+        pW->value = value;
+        pW->isChanged = true;
+    }
+    return 0;
+}
+/**
+ * @brief ウィジェットを表示/非表示にする。
+ *
+ * @param pW ウィジェット
+ * @param isVisible falseの場合、次のlcd_WidgetRender()で、描画していた範囲を空白にする。子のウィジェットも同じ。
+ * @return int 常に０
+ */
+int lcd_WidgetVisibleSet(LCDWidget *pW, bool isVisible)
+{
+    pW->isVisible = isVisible;
+    return 0;
+}
+/**
+ * @brief ウィジェットをモデルに書き込むときの優先度を設定する。
+ *
+ * @param pW ウィジェット
+ * @param pri 優先度
+ * @return int 常に０
+ */
+int lcd_WidgetPrioritySet(LCDWidget *pW, LCD_PRIORITY pri)
+{
+    pW->pri = pri;
+    return 0;
+}
+/**
+ * @brief 数値を、表示形式にしたがって幅の文字数の文字列にする。
+ *
+ * @param pW ウィジェット（LCD_WIDGET_NUMBER）
+ * @param pCells 文字列を入れるバッファ。空白で埋めてあること。
+ * @details 値が幅に収まらない場合は、幅の分だけ'*'にする。
+ */
+static void lcd_WidgetFormatNumber(LCDWidget *pW, char *pCells)
+{
+    char aryDigits[24];             // 下の桁から順に入れる
+    int n = 0;
+    int width = pW->width;
+    uint32_t mag = (pW->value < 0) ? (uint32_t)(-(int64_t)pW->value) : (uint32_t)pW->value;
+    for (int i = 0; ; ) {
+        aryDigits[n++] = '0' + mag % 10;
+        mag /= 10;
+        i++;
+        if (i == pW->decimals) aryDigits[n++] = '.';
+        if (mag == 0 && i > pW->decimals) break;
+    }
+    char sign = (pW->value < 0) ? '-' : (pW->isPlusSign && pW->value > 0) ? '+' : 0;
+    int length = n + (sign ? 1 : 0);
+    if (length > width) {
+        memset(pCells, '*', width);
+        return;
+    }
+    int pos;
+    if (pW->align == LCD_ALIGN_LEFT) {
+        pos = 0;
+    } else if (pW->align == LCD_ALIGN_CENTER) {
+        pos = (width - length) / 2;
+    } else if (pW->isZeroPad) {
+        memset(pCells, '0', width);
+        pos = 0;
+        length = width;             // 符号を先頭に置き、間を'0'で埋める
+    } else {
+        pos = width - length;
+    }
+    if (sign) pCells[pos] = sign;
+    for (int i = 0; i < n; i++) {
+        pCells[pos + length - 1 - i] = aryDigits[i];
+    }
+}
+/**
+ * @brief ウィジェットの内容を、幅の文字数の文字列にする。
+ *
+ * @param pW ウィジェット
+ * @param pCells 文字列を入れるバッファ。widthバイト。NULL文字は付けない。
+ */
+static void lcd_WidgetFormat(LCDWidget *pW, char *pCells)
+{
+    int width = pW->width;
+    memset(pCells, ' ', width);
+    switch (pW->type) {
+    case LCD_WIDGET_LABEL:
+        if (pW->pText != NULL) {
+            for (int i = 0; i < width && pW->pText[i] != '\0'; i++) {
+                pCells[i] = pW->pText[i];
+            }
+        }
+        break;
+    case LCD_WIDGET_NUMBER:
+        lcd_WidgetFormatNumber(pW, pCells);
+        break;
+    case LCD_WIDGET_BAR: {
+        int32_t value = pW->value;
+        if (value < 0) value = 0;
+        if (value > pW->maxValue) value = pW->maxValue;
+        // １文字を５段階に分け、端の文字だけを外字で表す
+        int dots = (int)((int64_t)value * width * 5 / pW->maxValue);
+        memset(pCells, 0xFF, dots / 5);         // 0xFFは全部の点が点灯した文字
+        if (dots % 5 > 0) pCells[dots / 5] = (char)(dots % 5 - 1);
+        break;
+    }
+    default:
+        break;
+    }
+}
+/**
+ * @brief 縦棒のバーを、必要な場合だけ描画する。行ごとに、前回と異なる文字だけをモデルに書き込む。
+ *
+ * @param pW ウィジェット（LCD_WIDGET_VBAR）
+ * @param line 絶対行
+ * @param column 絶対カラム
+ * @param isVisible 表示する場合はtrue
+ * @return int モデルに書き込んだ文字数
+ */
+static int lcd_WidgetRenderVBar(LCDWidget *pW, int line, int column, bool isVisible)
+{
+    int count = 0;
+    if (pW->isShown && (!isVisible || line != pW->shownLine || column != pW->shownColumn)) {
+        int width = pW->width;
+        if (width > MAX_CHARS - pW->shownColumn) width = MAX_CHARS - pW->shownColumn;
+        for (int row = 0; row < pW->height && pW->shownLine + row < MAX_LINES; row++) {
+            lcd_ModelFill(pW->shownLine + row, pW->shownColumn, ' ', width, pW->pri);
+            count += width;
+        }
+        pW->isShown = false;
+    }
+    if (!isVisible || line >= MAX_LINES || column >= MAX_CHARS) return count;
+    if (pW->isShown && !pW->isChanged) return count;
+
+    int width = pW->width;
+    if (width > MAX_CHARS - column) width = MAX_CHARS - column;
+    int32_t value = pW->value;
+    if (value < 0) value = 0;
+    if (value > pW->maxValue) value = pW->maxValue;
+    // １行を８段階に分け、下の行から埋める
+    int dots = (int)((int64_t)value * pW->height * 8 / pW->maxValue);
+    for (int row = 0; row < pW->height && line + row < MAX_LINES; row++) {
+        int rowDots = dots - (pW->height - 1 - row) * 8;
+        char c = (rowDots <= 0) ? ' ' : (rowDots >= 8) ? (char)0xFF : (char)(rowDots - 1);
+        if (pW->isShown && pW->aryShown[row] == c) continue;
+        lcd_ModelFill(line + row, column, c, width, pW->pri);
+        count += width;
+        pW->aryShown[row] = c;
+    }
+    pW->shownLine = line;
+    pW->shownColumn = column;
+    pW->isShown = true;
+    pW->isChanged = false;
+    return count;
+}
+/**
+ * @brief ウィジェットとその子を、必要な場合だけ描画する。
+ *
+ * @param pW ウィジェット
+ * @param line 親の絶対行
+ * @param column 親の絶対カラム
+ * @param isParentVisible 親が表示されている場合はtrue
+ * @return int モデルに書き込んだ文字数
+ */
+static int lcd_WidgetRenderNode(LCDWidget *pW, int line, int column, bool isParentVisible)
+{
+    int count = 0;
+    bool isVisible = isParentVisible && pW->isVisible;
+    line += pW->line;
+    column += pW->column;
+
+    if (pW->type == LCD_WIDGET_CONTAINER) {
+        for (LCDWidget *pChild = pW->pChild; pChild != NULL; pChild = pChild->pNext) {
+            count += lcd_WidgetRenderNode(pChild, line, column, isVisible);
+        }
+        return count;
+    }
+#if LCD_ICONEXIST
+    if (pW->type == LCD_WIDGET_ICON) {
+        bool isOn = isVisible && pW->value != 0;
+        if (isOn != pW->isShown || pW->isChanged) {
+            lcd_ModelIconSet(isOn, pW->icon, pW->pri);
+            pW->isShown = isOn;
+        }
+        pW->isChanged = false;
+        return 0;
+    }
+#endif
+    if (pW->type == LCD_WIDGET_VBAR) {
+        return lcd_WidgetRenderVBar(pW, line, column, isVisible);
+    }
+    // 前回と違う位置に描画する場合や、非表示になった場合は、前回描画した範囲を消す
+    if (pW->isShown && (!isVisible || line != pW->shownLine || column != pW->shownColumn)) {
+        int width = pW->width;
+        if (width > MAX_CHARS - pW->shownColumn) width = MAX_CHARS - pW->shownColumn;
+        lcd_ModelFill(pW->shownLine, pW->shownColumn, ' ', width, pW->pri);
+        count += width;
+        pW->isShown = false;
+    }
+    if (!isVisible || line >= MAX_LINES || column >= MAX_CHARS) return count;
+    if (pW->isShown && !pW->isChanged) return count;
+
+    char aryCells[LCD_WIDGET_WIDTH_MAX];
+    int width = pW->width;
+    if (width > MAX_CHARS - column) width = MAX_CHARS - column;       // 画面の右端で切り取る
+    lcd_WidgetFormat(pW, aryCells);
+    int from = 0;
+    int to = width;
+    if (pW->isShown) {
+        while (from < to && aryCells[from] == pW->aryShown[from]) from++;
+        while (to > from && aryCells[to - 1] == pW->aryShown[to - 1]) to--;
+    }
+    if (from < to) {
+        lcd_ModelWrite(line, column + from, &aryCells[from], to - from, pW->pri);
+        count += to - from;
+    }
+    memcpy(pW->aryShown, aryCells, pW->width);
+    pW->shownLine = line;
+    pW->shownColumn = column;
+    pW->isShown = true;
+    pW->isChanged = false;
+    return count;
+}
+/**
+ * @brief ウィジェットの木を描画する。値が変わったウィジェットの、前回と異なる範囲だけを表示内容のモデルに書き込む。
+ *
+ * @param pRoot 描画するウィジェット。木の途中のウィジェットを指定した場合は、その下だけを描画する。
+ * @return int モデルに書き込んだ文字数。何も変わっていない場合は０。
+ * @details 液晶への送信は、lcd_Flush()やlcd_flush_step()で行う。
+ */
+int lcd_WidgetRender(LCDWidget *pRoot)
+{
+    int line = 0;
+    int column = 0;
+    bool isVisible = true;
+    for (LCDWidget *pParent = pRoot->pParent; pParent != NULL; pParent = pParent->pParent) {
+        line += pParent->line;
+        column += pParent->column;
+        isVisible = isVisible && pParent->isVisible;
+    }
+    return lcd_WidgetRenderNode(pRoot, line, column, isVisible);
+}
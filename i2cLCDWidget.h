@@ -0,0 +1,132 @@
+/**
+ * @file i2cLCDWidget.h
+ * @author Hisayuki Nomura
+ * @brief ラベル、数値、アイコン、バーなどの部品（ウィジェット）を木構造で保持し、変わった部分だけを描画するためのヘッダファイル。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details ウィジェットを使用するプログラムは、i2cLCD.hに続けてこのヘッダファイルをincludeする。
+ */
+#ifndef __i2cLCDWidget_h__
+#define __i2cLCDWidget_h__
+
+#include "i2cLCD.h"
+
+/// @brief ウィジェットの最大の幅。描画した内容を覚えておくバッファの大きさになる。
+#define LCD_WIDGET_WIDTH_MAX    MAX_CHARS
+/// @brief 横棒のバーが使う外字の数（文字コード０～３）。１～４ドットの幅の縦線で、１文字を５段階に分ける。
+#define LCD_WIDGET_BAR_GLYPHS   4
+/// @brief 縦棒のバーが使う外字の数（文字コード０～６）。１～７ドットの高さの横線で、１文字を８段階に分ける。
+#define LCD_WIDGET_VBAR_GLYPHS  7
+
+/**
+ * @brief ウィジェットの種類
+ */
+enum LCD_WIDGET_TYPE : uint8_t {
+    /// @brief 子のウィジェットをまとめる入れ物。自分は何も描画しない。
+    LCD_WIDGET_CONTAINER,
+    /// @brief 文字列
+    LCD_WIDGET_LABEL,
+    /// @brief 整数の値
+    LCD_WIDGET_NUMBER,
+    /// @brief アイコン（液晶のアイコンを表示/消去する）
+    LCD_WIDGET_ICON,
+    /// @brief 値の大きさを横棒で表示する
+    LCD_WIDGET_BAR,
+    /// @brief 値の大きさを縦棒で表示する
+    LCD_WIDGET_VBAR
+};
+
+/**
+ * @brief 数値（LCD_WIDGET_NUMBER）を幅の中に寄せる方向
+ */
+enum LCD_WIDGET_ALIGN : uint8_t {
+    /// @brief 右寄せ（桁の位置がそろうので、変わった桁だけが送信されやすい）
+    LCD_ALIGN_RIGHT,
+    /// @brief 左寄せ
+    LCD_ALIGN_LEFT,
+    /// @brief 中央
+    LCD_ALIGN_CENTER
+};
+
+/**
+ * @brief ウィジェット。アプリケーションが静的に確保し、lcd_WidgetXxxInit()で初期化する。
+ * @details 位置は親のウィジェットからの相対位置で、親がない場合は画面の位置になる。
+ * 最後に描画した内容をaryShownに覚えておき、lcd_WidgetRender()では、描画し直した内容と異なる部分だけを表示内容のモデルに書き込む。
+ * 構造体の中身は、lcd_WidgetXxx()の関数を通して変更する。
+ */
+struct LCDWidget {
+    /// @brief ウィジェットの種類
+    LCD_WIDGET_TYPE type;
+    /// @brief 親からの相対的な行
+    uint8_t line;
+    /// @brief 親からの相対的なカラム
+    uint8_t column;
+    /// @brief 幅（文字数）。LCD_WIDGET_WIDTH_MAX以下
+    uint8_t width;
+    /// @brief 高さ（行数）。LCD_WIDGET_VBAR以外は１
+    uint8_t height;
+    /// @brief falseの場合は表示しない。子のウィジェットも表示しない。
+    bool isVisible;
+    /// @brief 値などが変わり、次のlcd_WidgetRender()で描画し直す必要がある場合はtrue
+    bool isChanged;
+    /// @brief 現在、画面に描画されている場合はtrue
+    bool isShown;
+    /// @brief モデルに書き込むときの優先度
+    LCD_PRIORITY pri;
+    /// @brief 親のウィジェット
+    LCDWidget *pParent;
+    /// @brief 最初の子のウィジェット
+    LCDWidget *pChild;
+    /// @brief 次の兄弟のウィジェット
+    LCDWidget *pNext;
+    /// @brief ラベルの文字列（LCD_WIDGET_LABEL）
+    const char *pText;
+    /// @brief 数値、バーの値、アイコンの表示（０以外で表示）
+    int32_t value;
+    /// @brief バーの最大値（LCD_WIDGET_BAR）
+    int32_t maxValue;
+    /// @brief 数値を寄せる方向（LCD_WIDGET_NUMBER）
+    LCD_WIDGET_ALIGN align;
+    /// @brief 小数点以下の桁数。値を10のdecimals乗で割った固定小数点として表示する（LCD_WIDGET_NUMBER）
+    uint8_t decimals;
+    /// @brief trueの場合、正の値に'+'を付ける（LCD_WIDGET_NUMBER）
+    bool isPlusSign;
+    /// @brief trueの場合、右寄せの空いた桁を'0'で埋める（LCD_WIDGET_NUMBER）
+    bool isZeroPad;
+    /// @brief 表示している値からの変化が、この値より小さい場合は表示を変えない（LCD_WIDGET_NUMBER）
+    int32_t deadband;
+#if LCD_ICONEXIST
+    /// @brief アイコン（LCD_WIDGET_ICON）
+    LCD_ICON icon;
+#endif
+    /// @brief 最後に描画した内容（描画した位置の絶対行、絶対カラムとともに覚えておく）。LCD_WIDGET_VBARは、行ごとの文字
+    char aryShown[LCD_WIDGET_WIDTH_MAX];
+    /// @brief 最後に描画した絶対行
+    uint8_t shownLine;
+    /// @brief 最後に描画した絶対カラム
+    uint8_t shownColumn;
+};
+
+int lcd_WidgetContainerInit(LCDWidget *pW, int line, int column);
+int lcd_WidgetLabelInit(LCDWidget *pW, int line, int column, int width, const char *pText);
+int lcd_WidgetNumberInit(LCDWidget *pW, int line, int column, int width, int32_t value);
+int lcd_WidgetBarInit(LCDWidget *pW, int line, int column, int width, int32_t maxValue);
+int lcd_WidgetVBarInit(LCDWidget *pW, int line, int column, int width, int height, int32_t maxValue);
+int lcd_WidgetBarGlyphLoad(bool isVertical);
+#if LCD_ICONEXIST
+int lcd_WidgetIconInit(LCDWidget *pW, LCD_ICON icon);
+#endif
+int lcd_WidgetNumberFormatSet(LCDWidget *pW, LCD_WIDGET_ALIGN align, int decimals, bool isPlusSign, bool isZeroPad);
+int lcd_WidgetDeadbandSet(LCDWidget *pW, int32_t deadband);
+int lcd_WidgetAdd(LCDWidget *pParent, LCDWidget *pChild);
+int lcd_WidgetTextSet(LCDWidget *pW, const char *pText);
+int lcd_WidgetValueSet(LCDWidget *pW, int32_t value);
+int lcd_WidgetVisibleSet(LCDWidget *pW, bool isVisible);
+int lcd_WidgetPrioritySet(LCDWidget *pW, LCD_PRIORITY pri);
+int lcd_WidgetRender(LCDWidget *pRoot);
+
+#endif
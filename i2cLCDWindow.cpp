@@ -0,0 +1,209 @@
+/**
+ * @file i2cLCDWindow.cpp
+ * @author Hisayuki Nomura
+ * @brief 画面の一部の矩形を、独立したカーソルとスクロールを持つウィンドウとして使うための処理。\n
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details lcd_CursorPositionとlcd_stringの組み合わせでは、画面の右端を超えて書いた文字は、見えないDDRAMに書き込まれてしまう。
+ * また、ステータス、ログ、値などの領域をそれぞれ更新するには、毎回カーソル位置を管理する必要がある。\n
+ * ウィンドウは、画面の中の矩形の領域と、その中だけのカーソルを持ち、出力はウィンドウの中に切り取られる。
+ * 出力はすべて表示内容のモデルを通して行うので、ウィンドウの中をスクロールしても、実際に内容が変わったセルだけが送信される。
+ *
+ * @code
+ *  LCDWindow winLog, winValue;
+ *  lcd_WindowInit(&winLog, 0, 0, 2, 10);       // 左側10文字x2行をログに
+ *  lcd_WindowInit(&winValue, 0, 11, 1, 5);     // 右上5文字を値の表示に
+ *  lcd_WindowPrintf(&winLog, "start\n");
+ *  lcd_WindowCursorSet(&winValue, 0, 0);
+ *  lcd_WindowPrintf(&winValue, "%5d", value);
+ *  lcd_Flush();
+ * @endcode
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "i2cLCD.h"
+#include "i2cLCDlocal.h"
+#include "i2cLCDWindow.h"
+
+/**
+ * @brief ウィンドウを初期化する。画面の内容は変更しない。
+ *
+ * @param pWin 初期化するウィンドウ
+ * @param line 左上の行（0～MAX_LINES-1）
+ * @param column 左上のカラム（0～MAX_CHARS-1）
+ * @param height 行数
+ * @param width カラム数
+ * @return int ０。ウィンドウが画面からはみ出す場合は-1。
+ * @details 折り返しとスクロールはオン、優先度はLCD_PRI_NORMALになる。変更する場合はlcd_WindowModeSet()を使う。
+ */
+int lcd_WindowInit(LCDWindow *pWin, int line, int column, int height, int width)
+{
+    if (line < 0 || column < 0 || height <= 0 || width <= 0) return -1;
+    if (line + height > MAX_LINES || column + width > MAX_CHARS) return -1;
+    pWin->line = line;
+    pWin->column = column;
+    pWin->height = height;
+    pWin->width = width;
+    pWin->curLine = 0;
+    pWin->curColumn = 0;
+    pWin->isWrap = true;
+    pWin->isScroll = true;
+    pWin->pri = LCD_PRI_NORMAL;
+    return 0;
+}
+/**
+ * @brief ウィンドウの折り返し、スクロール、優先度を設定する。
+ *
+ * @param pWin ウィンドウ
+ * @param isWrap trueの場合、右端を超えると次の行に折り返す。falseの場合は捨てる。
+ * @param isScroll trueの場合、最後の行を超えるとスクロールする。falseの場合は捨てる。
+ * @param pri モデルに書き込むときの優先度
+ * @return int 常に０
+ */
+int lcd_WindowModeSet(LCDWindow *pWin, bool isWrap, bool isScroll, LCD_PRIORITY pri)
+{
+    pWin->isWrap = isWrap;
+    pWin->isScroll = isScroll;
+    pWin->pri = pri;
+    return 0;
+}
+/**
+ * @brief ウィンドウの中を空白にし、カーソルを左上に戻す。
+ *
+ * @param pWin ウィンドウ
+ * @return int 常に０
+ */
+int lcd_WindowClear(LCDWindow *pWin)
+{
+    for (int r = 0; r < pWin->height; r++) {
+        lcd_ModelFill(pWin->line + r, pWin->column, ' ', pWin->width, pWin->pri);
+    }
+    pWin->curLine = 0;
+    pWin->curColumn = 0;
+    return 0;
+}
+/**
+ * @brief ウィンドウの中のカーソル位置を設定する。
+ *
+ * @param pWin ウィンドウ
+ * @param line ウィンドウの中の行
+ * @param column ウィンドウの中のカラム
+ * @return int ０。ウィンドウの外の場合は-1。
+ */
+int lcd_WindowCursorSet(LCDWindow *pWin, int line, int column)
+{
+    if (line < 0 || line >= pWin->height || column < 0 || column >= pWin->width) return -1;
+    pWin->curLine = line;
+    pWin->curColumn = column;
+    return 0;
+}
+/**
+ * @brief ウィンドウの中を、指定された行数だけ上にスクロールする。下に空いた行は空白になる。
+ *
+ * @param pWin ウィンドウ
+ * @param lines スクロールする行数
+ * @return int 常に０
+ * @details ウィンドウの中の内容を、表示内容のモデルの上で移動する。移動の前後で同じ文字のセルは送信されない。
+ */
+int lcd_WindowScroll(LCDWindow *pWin, int lines)
+{
+    if (lines <= 0) return 0;
+    for (int r = 0; r < pWin->height; r++) {
+        for (int c = 0; c < pWin->width; c++) {
+            char ch = (r + lines < pWin->height) ? (char)lcd_ModelGet(pWin->line + r + lines, pWin->column + c) : ' ';
+            lcd_ModelWrite(pWin->line + r, pWin->column + c, &ch, 1, pWin->pri);
+        }
+    }
+    return 0;
+}
+/**
+ * @brief カーソルを次の行の先頭に移動する。最後の行の場合は、スクロールするか、それ以降の出力を捨てる。
+ *
+ * @param pWin ウィンドウ
+ */
+static void lcd_WindowNewLine(LCDWindow *pWin)
+{
+    pWin->curColumn = 0;
+    if (pWin->curLine + 1 < pWin->height) {
+        pWin->curLine++;
+    } else if (pWin->isScroll) {
+        lcd_WindowScroll(pWin, 1);
+    } else {
+        pWin->curLine = pWin->height;       // ウィンドウの外。lcd_WindowCursorSetかlcd_WindowClearまで何も書き込まない
+    }
+}
+/**
+ * @brief ウィンドウのカーソル位置から、文字列を書き込む。
+ *
+ * @param pWin ウィンドウ
+ * @param s 書き込む文字列。'\n'で次の行に、'\r'で行の先頭に移動する。
+ * @param length 書き込む長さ。負の値の場合は文字列の長さ（NULL文字まで）。
+ * @return int ウィンドウの中に書き込んだ文字数
+ * @details 右端で折り返す場合、次の行への移動は、右端を超えて次の文字を書くときに行う。
+ * そのため、ちょうど行の幅の文字列に続けて'\n'を書いても、空の行はできない。
+ */
+int lcd_WindowWrite(LCDWindow *pWin, const char *s, int length)
+{
+    int count = 0;
+    if (length < 0) {
+        length = strlen(s);
+    }
+    for (int i = 0; i < length; i++) {
+        char c = s[i];
+        if (c == '\n') {
+            if (pWin->curLine < pWin->height) lcd_WindowNewLine(pWin);
+            continue;
+        }
+        if (c == '\r') {
+            pWin->curColumn = 0;
+            continue;
+        }
+        if (pWin->curColumn >= pWin->width) {
+            if (!pWin->isWrap || pWin->curLine >= pWin->height) continue;
+            lcd_WindowNewLine(pWin);
+        }
+        if (pWin->curLine >= pWin->height) continue;
+        lcd_ModelWrite(pWin->line + pWin->curLine, pWin->column + pWin->curColumn, &c, 1, pWin->pri);
+        pWin->curColumn++;
+        count++;
+    }
+    return count;
+}
+/**
+ * @brief ウィンドウのカーソル位置から、文字列(NULL終了)を書き込む。
+ *
+ * @param pWin ウィンドウ
+ * @param s 書き込む文字列
+ * @return int ウィンドウの中に書き込んだ文字数
+ */
+int lcd_WindowWrite(LCDWindow *pWin, const char *s)
+{
+    return lcd_WindowWrite(pWin, s, -1);
+}
+/**
+ * @brief ウィンドウのカーソル位置から、フォーマットされた文字列を書き込む。
+ *
+ * @param pWin ウィンドウ
+ * @param format C標準のprintfフォーマット
+ * @param ...
+ * @return int ウィンドウの中に書き込んだ文字数
+ * @details フォーマットした結果は、画面全体の文字数(MAX_LINES*MAX_CHARS)までで切り捨てられる。
+ */
+int lcd_WindowPrintf(LCDWindow *pWin, const char *format, ...)
+{
+    char aryBuf[MAX_LINES * MAX_CHARS + 1];
+    va_list va;
+    va_start(va, format);
+    vsnprintf(aryBuf, sizeof(aryBuf), format, va);
+    va_end(va);
+    return lcd_WindowWrite(pWin, aryBuf, -1);
+}
@@ -0,0 +1,54 @@
+/**
+ * @file i2cLCDWindow.h
+ * @author Hisayuki Nomura
+ * @brief 画面の一部の矩形を、独立したカーソルとスクロールを持つウィンドウとして使うためのヘッダファイル。
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2024 \n
+ * このプログラムの使用、再配布などは自由です。利用については個人の責任で使用してください。
+ *
+ * @details ウィンドウを使用するプログラムは、i2cLCD.hに続けてこのヘッダファイルをincludeする。
+ */
+#ifndef __i2cLCDWindow_h__
+#define __i2cLCDWindow_h__
+
+#include "i2cLCD.h"
+
+/**
+ * @brief 画面の一部の矩形の領域。
+ * @details ウィンドウへの出力は、ウィンドウの中だけに書き込まれ、はみ出した部分は捨てられる（クリッピング）。
+ * 出力は表示内容のモデルに書き込まれ、液晶への送信はlcd_Flush()などで行う。\n
+ * 構造体の中身は、lcd_WindowInit()とlcd_WindowModeSet()で設定する。
+ */
+struct LCDWindow {
+    /// @brief ウィンドウの左上の行
+    uint8_t line;
+    /// @brief ウィンドウの左上のカラム
+    uint8_t column;
+    /// @brief ウィンドウの行数
+    uint8_t height;
+    /// @brief ウィンドウのカラム数
+    uint8_t width;
+    /// @brief ウィンドウの中のカーソルの行
+    uint8_t curLine;
+    /// @brief ウィンドウの中のカーソルのカラム
+    uint8_t curColumn;
+    /// @brief trueの場合、右端を超えると次の行に折り返す。falseの場合、右端を超えた部分は捨てる
+    bool isWrap;
+    /// @brief trueの場合、最後の行を超えるとウィンドウの中だけをスクロールする。falseの場合、最後の行を超えた部分は捨てる
+    bool isScroll;
+    /// @brief モデルに書き込むときの優先度
+    LCD_PRIORITY pri;
+};
+
+int lcd_WindowInit(LCDWindow *pWin, int line, int column, int height, int width);
+int lcd_WindowModeSet(LCDWindow *pWin, bool isWrap, bool isScroll, LCD_PRIORITY pri);
+int lcd_WindowClear(LCDWindow *pWin);
+int lcd_WindowCursorSet(LCDWindow *pWin, int line, int column);
+int lcd_WindowWrite(LCDWindow *pWin, const char *s, int length);
+int lcd_WindowWrite(LCDWindow *pWin, const char *s);
+int lcd_WindowPrintf(LCDWindow *pWin, const char *format, ...);
+int lcd_WindowScroll(LCDWindow *pWin, int lines);
+
+#endif
@@ -280,11 +280,198 @@ struct LCDSetting {
     uint8_t curPosLine;
     /// @brief 現在のカーソルのカラム
     uint8_t curPosColumn;
+    /// @brief 液晶コントローラのアドレスカウンタ（AC）の現在値。lcd_Flushなどでカーソル位置以外に書き込んだ後は、curPosLine/curPosColumnと一致しない。
+    /// @details 0xFFの場合は不明（CGRAMやアイコンのアドレスを指している）。
+    uint8_t hwAddr;
+    /// @brief 表示のシフト量。画面の左端に表示されているDDRAMのカラム（0～DDRAM_CHARS-1）。
+    /// @details lcd_DisplayShift()で左にシフトすると増え、lcd_ClearDisplay()やlcd_ReturnHome()で０に戻る。
+    uint8_t displayShift;
+    /// @brief CGRAMに登録されている外字を、どの機能が登録したか（LCD_CGRAM_OWNER_xxx）。
+    /// @details lcd_CGRAMWrite()やlcd_CGRAMSet()でCGRAMを書き換えると、LCD_CGRAM_OWNER_NONEに戻る。
+    /// 登録した機能は、書き込みが終わった後に自分の値を設定し、次に使うときに値が変わっていなければ登録を省く。
+    uint8_t cgramOwner;
+    /// @brief 液晶コントローラが、最後に送信した命令を実行し終わる時刻(time_us_64()の値)。
+    /// @details 次の送信はこの時刻まで待ってから行う。sleep_usで待つ代わりにこの時刻を記録しておくことで、待ち時間の間に別の処理ができる。
+    uint64_t busyUntil;
+    /// @brief I2Cの速度（Hz）。送信にかかる時間の見積もりに使用する。
+    uint32_t busHz;
+    /// @brief 送信したトランザクション数とバイト数。lcd_BusStatsGet()で取得する。
+    LCDBusStats busStats;
+    /// @brief CPUが動いていた時間と休んでいた時間。lcd_CpuStatsGet()で取得する。
+    LCDCpuStats cpuStats;
+    /// @brief lcd_FlushAsync()のバックグラウンドの送信が続いている場合はtrue
+    volatile bool isAsyncActive;
+    /// @brief lcd_FlushAsync()のアラームが、次のランを送信してよいことを知らせた場合はtrue。lcd_FlushAsyncPoll()で送信して落とす。
+    volatile bool isAsyncPending;
+    /// @brief lcd_FlushAsyncPoll()が送信している場合はtrue。この間は、lcd_AsyncStop()でバックグラウンドの送信を止めない。
+    bool isInAsync;
+    /// @brief lcd_FlushAsync()のアラームのID
+    alarm_id_t asyncAlarm;
+    /// @brief lcd_FlushAsyncPoll()の１回の送信で使用してよい時間（μ秒）
+    uint32_t asyncBudgetUs;
+    /// @brief アプリケーションがI2Cを使用中であることを示すカウンタ。lcd_BusLock()/lcd_BusUnlock()で増減する。
+    volatile uint8_t busLock;
 };
+/// @brief LCDSetting.cgramOwner：CGRAMの内容を知っている機能は無い
+#define LCD_CGRAM_OWNER_NONE    0
+/// @brief LCDSetting.cgramOwner：ウィジェットの横棒の部品
+#define LCD_CGRAM_OWNER_BAR     1
+/// @brief LCDSetting.cgramOwner：ウィジェットの縦棒の部品
+#define LCD_CGRAM_OWNER_VBAR    2
+
 /**
  * @brief 現在のLCDに対する設定値を保存する構造体の実体。Strawberry 液晶は現在の状態を読みだすことができないので、このライブラリで行った設定を保存しておく
- * @details 詳細は、データ構造を参照。
+ * @details 詳細は、データ構造を参照。実体はi2cLCD.cppにある。
 */
-struct LCDSetting lcdSetting;
+extern struct LCDSetting lcdSetting;
+
+/// @brief LCDに送信する際のコントロールバイトのCoビット。これが立っている場合、データ１バイトの後に再びコントロールバイトが続く。
+const static uint8_t LCD_CONTINUE = 0x80;
+
+/// @brief １回のI2Cトランザクションで送信できる最大バイト数。DDRAM１行分のデータと、いくつかのコマンドが入る大きさ。
+#define LCD_BATCH_MAX   (DDRAM_CHARS + 16)
+
+/**
+ * @brief 複数のコマンドとデータを１回のI2Cトランザクションにまとめて送信するためのバッファ。
+ * @details ST7032では、コントロールバイトのCoビットを立てると、データ１バイトの後にもう一度コントロールバイトを送ることができる。
+ * これを利用して、[0x80,コマンド,0x80,コマンド,...,0x40,データ,データ...]のように、複数のコマンドと、最後に連続したデータを
+ * １回のトランザクションで送信する。連続したデータ(lcd_BatchDataRun)は最後にしか置けない。\n
+ * lcd_BatchInit()で初期化し、lcd_BatchCommand()などで追加した後、lcd_BatchSend()で送信する。
+ */
+struct LCDBatch {
+    /// @brief 送信するバイト列
+    uint8_t aryData[LCD_BATCH_MAX];
+    /// @brief aryDataの有効なバイト数
+    int length;
+    /// @brief 最後のコントロールバイトの位置。送信時にこのバイトのCoビットを落とす。-1の場合はまだ何もない。
+    int lastCtrl;
+    /// @brief 連続データを追加した後はtrueになり、それ以上追加できない。
+    bool isClosed;
+    /// @brief 最後の命令の実行にかかる時間（μ秒）。送信後、この時間だけ液晶コントローラがビジーになる。
+    uint32_t execUs;
+};
+
+void lcd_BatchInit(LCDBatch *pBatch);
+bool lcd_BatchCommand(LCDBatch *pBatch, uint8_t cmd, uint32_t execUs);
+bool lcd_BatchDataByte(LCDBatch *pBatch, uint8_t val);
+bool lcd_BatchDataRun(LCDBatch *pBatch, const uint8_t *buf, int length);
+int lcd_BatchSend(LCDBatch *pBatch);
+int lcd_BusWrite(const uint8_t *buf, int length, uint32_t execUs);
+void lcd_WaitReady(void);
+void lcd_ExtendBusy(uint32_t execUs);
+uint32_t lcd_BusTimeUs(int length);
+void lcd_AsyncStop(void);
+
+/// @brief lcd_FlushAsync()で、I2Cがアプリケーションに使用されていた場合に、もう一度試すまでの時間（μ秒）
+#define LCD_ASYNC_RETRY_US  50
+uint8_t lcd_DDRAMAddr(int line, int column);
+
+/// @brief lcd_begin()のトランザクションを入れ子にできる最大の深さ
+#define LCD_TX_DEPTH    4
+/// @brief lcd_commit()で、変更を１回のI2Cトランザクションにまとめるバッファの大きさ。
+/// @details アイコン16個（68バイト）、２行のすべてのセルを[0xC0][文字]の組で送る場合（82バイト×２）、エントリーモードの切り替えとカーソルの位置が入る。
+#define LCD_COMMIT_MAX  256
+/// @brief lcd_OverlayShow()で重ねて表示できるオーバーレイの最大の数
+#define LCD_OVERLAY_MAX 4
+
+/**
+ * @brief 液晶に表示する内容のモデル（シャドウDDRAM）。
+ * @details aryCellはアプリケーションが表示したい内容、arySentは液晶に送信済みの内容を持つ。
+ * 両者が異なるセルが未送信のセルであり、lcd_Flush()やlcd_flush_step()で、異なる部分だけがまとめて送信される。\n
+ * aryDirtyFrom～aryDirtyToは、行ごとに未送信のセルがあるかもしれない範囲で、送信するセルを探すときに、この範囲だけを調べる。
+ * lcd_stringなど、直接液晶に書き込む関数は、書き込んだ内容をaryCellとarySentの両方に反映する。\n
+ * アプリケーションが書き込むのはaryBaseで、aryCellはaryBaseの上にオーバーレイ（lcd_OverlayShow）を重ね合わせた結果になる。
+ */
+struct LCDModel {
+    /// @brief 表示したい内容。DDRAMと同じく、１行あたりDDRAM_CHARS文字
+    uint8_t aryCell[MAX_LINES][DDRAM_CHARS];
+    /// @brief オーバーレイの下の内容。lcd_ModelWrite()などで書き込まれる。
+    uint8_t aryBase[MAX_LINES][DDRAM_CHARS];
+    /// @brief 液晶に送信済みの内容
+    uint8_t arySent[MAX_LINES][DDRAM_CHARS];
+    /// @brief 未送信のセルがあるかもしれない範囲の先頭カラム
+    uint8_t aryDirtyFrom[MAX_LINES];
+    /// @brief 未送信のセルがあるかもしれない範囲の末尾カラム+1。aryDirtyFrom以下の場合、その行に未送信のセルは無い
+    uint8_t aryDirtyTo[MAX_LINES];
+    /// @brief 次に送信するセルを探し始める行。一つの行ばかりが送信されないように、行を順番に回す。
+    uint8_t nextLine;
+    /// @brief 未送信のセルの優先度（LCD_PRIORITY）。LCD_LANE_FORCEが立っている場合は、送信済みの内容と同じでも送信する。
+    uint8_t aryLane[MAX_LINES][DDRAM_CHARS];
+    /// @brief セルが未送信になった時刻（time_us_32()の値）。待ち時間の統計に使用する。
+    uint32_t aryStamp[MAX_LINES][DDRAM_CHARS];
+#if LCD_ICONEXIST
+    /// @brief 表示したいアイコンの状態。送信済みの状態はlcdSetting.aryIconValueにある。
+    uint8_t aryIconCell[16];
+    /// @brief 未送信のアイコンの優先度
+    uint8_t aryIconLane[16];
+    /// @brief アイコンが未送信になった時刻
+    uint32_t aryIconStamp[16];
+#endif
+    /// @brief 優先度ごとの待ち時間の統計
+    LCDLatencyStats aryLatency[LCD_PRIORITY_COUNT];
+    /// @brief フレームの間隔（μ秒）。０以外の場合は、lcd_stringなどもモデルに書き込み、lcd_FrameTick()でまとめて送信する。
+    uint32_t frameIntervalUs;
+    /// @brief 次のフレームを始めてよい時刻（time_us_64()の値）
+    uint64_t nextFrameUs;
+    /// @brief 送信し終わっていないフレームがある場合はtrue
+    bool isFrameOpen;
+    /// @brief フレームの統計
+    LCDFrameStats frameStats;
+    /// @brief lcd_begin()で始めたトランザクションの入れ子の深さ。０の場合はトランザクションの外。
+    uint8_t txDepth;
+    /// @brief トランザクションを始めたときの表示内容。lcd_abort()で元に戻すために使用する。
+    uint8_t arySnapCell[LCD_TX_DEPTH][MAX_LINES][DDRAM_CHARS];
+    /// @brief トランザクションを始めたときのカーソルの行
+    uint8_t arySnapLine[LCD_TX_DEPTH];
+    /// @brief トランザクションを始めたときのカーソルのカラム
+    uint8_t arySnapColumn[LCD_TX_DEPTH];
+#if LCD_ICONEXIST
+    /// @brief トランザクションを始めたときのアイコンの状態
+    uint8_t arySnapIcon[LCD_TX_DEPTH][16];
+#endif
+    /// @brief ページ切り替えモード（lcd_PageFlipMode）を使用している場合はtrue
+    bool isPageFlip;
+    /// @brief 表示しているページ（０はカラム０～MAX_CHARS-1、１はカラムMAX_CHARS～MAX_CHARS*2-1）
+    uint8_t frontPage;
+    /// @brief 表示しているオーバーレイ。後ろにあるものほど上に重なる。
+    LCDOverlay *aryOverlay[LCD_OVERLAY_MAX];
+    /// @brief 表示しているオーバーレイの数
+    uint8_t overlayCount;
+    /// @brief 点滅させるセル。行ごとに、ビットの位置がカラムになる。
+    uint64_t aryBlinkMask[MAX_LINES];
+#if LCD_ICONEXIST
+    /// @brief 点滅させるアイコンのビット。アイコンのアドレスごと
+    uint8_t aryIconBlink[16];
+#endif
+    /// @brief 点滅の周期（μ秒）。０の場合はLCD_BLINK_PERIOD_MS。
+    uint32_t blinkPeriodUs;
+    /// @brief 点滅の周期のうち、消えている側の半周期の場合はtrue
+    bool isBlinkOff;
+};
+/// @brief LCDModel.aryLaneで、送信済みの内容と同じでも送信することを示すビット。lcd_ModelRefresh()で使用する。
+#define LCD_LANE_FORCE  0x80
+/// @brief LCDModel.aryLaneから、優先度を取り出すマスク
+#define LCD_LANE_MASK   0x03
+/// @brief 液晶に表示する内容のモデルの実体。i2cLCDModel.cppにある。
+extern struct LCDModel lcdModel;
+
+/**
+ * @brief lcd_stringなどを、液晶に送信せずにモデルに書き込むかどうかを調べる。
+ *
+ * @return bool フレームレートを制限している場合か、lcd_begin()のトランザクションの中の場合はtrue
+ */
+static inline bool lcd_IsBuffered(void)
+{
+    return lcdModel.frameIntervalUs != 0 || lcdModel.txDepth > 0;
+}
+
+void lcd_ModelMirror(int line, int column, const uint8_t *buf, int length);
+void lcd_ModelMirrorClear(void);
+#if LCD_ICONEXIST
+void lcd_ModelMirrorIcon(uint8_t iconAddr, uint8_t bits, bool isDisp);
+#endif
+uint8_t lcd_FunctionSetCmd(bool isExtInstruction);
+int lcd_CursorAddrSet(int line, int position);
+int lcd_FlushPriority(LCD_PRIORITY minPri);
 
 #endif
\ No newline at end of file